@@ -19,11 +19,48 @@
 
 namespace manifold {
 
+/** @addtogroup Private
+ *  @{
+ */
+constexpr uint32_t kNoCode = 0xFFFFFFFFu;
+
+__host__ __device__ inline uint32_t SpreadBits3(uint32_t v) {
+  v = 0xFF0000FFu & (v * 0x00010001u);
+  v = 0x0F00F00Fu & (v * 0x00000101u);
+  v = 0xC30C30C3u & (v * 0x00000011u);
+  v = 0x49249249u & (v * 0x00000005u);
+  return v;
+}
+
+/**
+ * The Morton code of a position within bBox, by which the leaves of a Collider
+ * must be sorted.
+ */
+__host__ __device__ inline uint32_t MortonCode(glm::vec3 position, Box bBox) {
+  // Unreferenced vertices are marked NaN, and this will sort them to the end
+  // (the Morton code only uses the first 30 of 32 bits).
+  if (isnan(position.x)) return kNoCode;
+
+  glm::vec3 xyz = (position - bBox.min) / (bBox.max - bBox.min);
+  xyz = glm::min(glm::vec3(1023.0f), glm::max(glm::vec3(0.0f), 1024.0f * xyz));
+  uint32_t x = SpreadBits3(static_cast<uint32_t>(xyz.x));
+  uint32_t y = SpreadBits3(static_cast<uint32_t>(xyz.y));
+  uint32_t z = SpreadBits3(static_cast<uint32_t>(xyz.z));
+  return x * 4 + y * 2 + z;
+}
+/** @} */
+
 /** @ingroup Private */
 class Collider {
  public:
   Collider() {}
   Collider(const VecDH<Box>& leafBB, const VecDH<uint32_t>& leafMorton);
+  // Grafts existing colliders under a new top-level tree, where leafBB holds
+  // the boxes of all of their leaves, concatenated in order.
+  Collider(const std::vector<const Collider*>& children,
+           const VecDH<Box>& leafBB);
+  // False if grafting these children would make the tree too deep.
+  static bool CanGraft(const std::vector<const Collider*>& children);
   // Aborts and returns false if transform is not axis aligned.
   bool Transform(glm::mat4x3);
   void UpdateBoxes(const VecDH<Box>& leafBB);
@@ -37,9 +74,13 @@ class Collider {
   VecDH<int> nodeParent_;
   // even nodes are leaves, odd nodes are internal, root is 1
   VecDH<thrust::pair<int, int>> internalChildren_;
+  // upper bound on the internal nodes between the root and any leaf
+  int depth_ = 0;
+
+  static int GraftDepth(const std::vector<const Collider*>& children);
 
   int NumInternal() const { return internalChildren_.size(); };
-  int NumLeaves() const { return NumInternal() + 1; };
+  int NumLeaves() const { return (nodeBBox_.size() + 1) / 2; };
 };
 
 }  // namespace manifold
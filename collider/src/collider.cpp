@@ -14,6 +14,8 @@
 
 #include "collider.h"
 
+#include <algorithm>
+
 #include "par.h"
 #include "utils.h"
 
@@ -26,6 +28,8 @@ constexpr int kInitialLength = 128;
 constexpr int kLengthMultiple = 4;
 // Fundamental constants
 constexpr int kRoot = 1;
+// Size of the traversal stack in FindCollisions, which bounds the depth.
+constexpr int kMaxDepth = 64;
 
 #ifdef _MSC_VER
 
@@ -66,6 +70,16 @@ __host__ __device__ int Internal2Node(int internal) { return internal * 2 + 1; }
 __host__ __device__ int Node2Leaf(int node) { return node / 2; }
 __host__ __device__ int Leaf2Node(int leaf) { return leaf * 2; }
 
+// Upper bound on the internal nodes from the root to any leaf of a radix tree
+// over numLeaf leaves: each level down takes at least one more bit of the
+// 32-bit Morton code, or of the index that disambiguates equal codes.
+int RadixDepth(int numLeaf) {
+  if (numLeaf < 2) return 0;
+  int indexBits = 0;
+  while (indexBits < 31 && (1 << indexBits) < numLeaf) ++indexBits;
+  return std::min(numLeaf - 1, 32 + indexBits);
+}
+
 struct CreateRadixTree {
   int* nodeParent_;
   thrust::pair<int, int>* internalChildren_;
@@ -182,9 +196,9 @@ struct FindCollisions {
   }
 
   __host__ __device__ void operator()(thrust::tuple<T, int> query) {
-    // stack cannot overflow because radix tree has max depth 30 (Morton code) +
-    // 32 (index).
-    int stack[64];
+    // stack cannot overflow because a radix tree has max depth 32 (Morton code)
+    // + 31 (index), and grafted trees are refused beyond kMaxDepth.
+    int stack[kMaxDepth];
     int top = -1;
     // Depth-first search
     int node = kRoot;
@@ -229,6 +243,36 @@ struct BuildInternalBoxes {
   }
 };
 
+struct GraftTree {
+  thrust::pair<int, int>* internalChildren_;
+  int* nodeParent_;
+  const thrust::pair<int, int>* childInternalChildren_;
+  const int leafOffset_;
+  const int internalOffset_;
+
+  __host__ __device__ int Remap(int node) const {
+    return IsLeaf(node) ? Leaf2Node(Node2Leaf(node) + leafOffset_)
+                        : Internal2Node(Node2Internal(node) + internalOffset_);
+  }
+
+  __host__ __device__ void operator()(int childInternal) {
+    const int internal = childInternal + internalOffset_;
+    const int child1 = Remap(childInternalChildren_[childInternal].first);
+    const int child2 = Remap(childInternalChildren_[childInternal].second);
+    internalChildren_[internal].first = child1;
+    internalChildren_[internal].second = child2;
+    const int node = Internal2Node(internal);
+    nodeParent_[child1] = node;
+    nodeParent_[child2] = node;
+  }
+};
+
+struct UnionBox : public thrust::binary_function<Box, Box, Box> {
+  __host__ __device__ Box operator()(const Box& a, const Box& b) {
+    return a.Union(b);
+  }
+};
+
 struct TransformBox {
   const glm::mat4x3 transform;
   __host__ __device__ void operator()(Box& box) {
@@ -246,6 +290,7 @@ namespace manifold {
  */
 Collider::Collider(const VecDH<Box>& leafBB,
                    const VecDH<uint32_t>& leafMorton) {
+  TraceScope trace("Collider");
   ALWAYS_ASSERT(leafBB.size() == leafMorton.size(), userErr,
                 "vectors must be the same length");
   int num_nodes = 2 * leafBB.size() - 1;
@@ -257,6 +302,116 @@ Collider::Collider(const VecDH<Box>& leafBB,
   for_each_n(autoPolicy(NumInternal()), countAt(0), NumInternal(),
              CreateRadixTree(
                  {nodeParent_.ptrD(), internalChildren_.ptrD(), leafMorton}));
+  depth_ = RadixDepth(leafBB.size());
+  UpdateBoxes(leafBB);
+}
+
+/**
+ * Returns whether the given colliders can be grafted together. Each graft adds
+ * a level of top tree above the children's, so after enough of them the result
+ * would be too deep to traverse, and a new Collider should be built instead.
+ */
+bool Collider::CanGraft(const std::vector<const Collider*>& children) {
+  return GraftDepth(children) <= kMaxDepth;
+}
+
+int Collider::GraftDepth(const std::vector<const Collider*>& children) {
+  int numChild = 0;
+  int childDepth = 0;
+  for (const Collider* child : children) {
+    if (child->NumLeaves() == 0) continue;
+    ++numChild;
+    childDepth = std::max(childDepth, child->depth_);
+  }
+  return RadixDepth(numChild) + childDepth;
+}
+
+/**
+ * Creates a two-level BVH by reusing the hierarchies of the given children,
+ * whose leaves are numbered consecutively in the order given, so that leafBB
+ * must contain all of their leaf boxes in this order. The children are linked
+ * under a new radix tree built over their overall bounding boxes, so only this
+ * small top level and the box updates need to be computed. This is ideal for
+ * composing parts that were already sorted and collided individually.
+ */
+Collider::Collider(const std::vector<const Collider*>& childrenIn,
+                   const VecDH<Box>& leafBB) {
+  TraceScope trace("Collider from children");
+  std::vector<const Collider*> children;
+  std::vector<int> leafOffset;
+  std::vector<int> internalOffset;
+  int numLeaf = 0;
+  for (const Collider* child : childrenIn) {
+    if (child->NumLeaves() == 0) continue;
+    children.push_back(child);
+    leafOffset.push_back(numLeaf);
+    numLeaf += child->NumLeaves();
+  }
+  ALWAYS_ASSERT(leafBB.size() == numLeaf, userErr,
+                "must have the same number of boxes as child leaves");
+  ALWAYS_ASSERT(CanGraft(children), userErr,
+                "grafted collider would be too deep; check CanGraft first");
+  const int numChild = children.size();
+  if (numChild == 0) return;
+
+  // The top-level internal nodes come first, followed by each child's.
+  int numInternal = numChild - 1;
+  for (const Collider* child : children) {
+    internalOffset.push_back(numInternal);
+    numInternal += child->NumInternal();
+  }
+  depth_ = GraftDepth(children);
+  nodeBBox_.resize(2 * numLeaf - 1);
+  nodeParent_.resize(2 * numLeaf - 1, -1);
+  internalChildren_.resize(numLeaf - 1, thrust::make_pair(-1, -1));
+
+  for (int i = 0; i < numChild; ++i) {
+    const Collider& child = *children[i];
+    for_each_n(autoPolicy(child.NumInternal()), countAt(0), child.NumInternal(),
+               GraftTree({internalChildren_.ptrD(), nodeParent_.ptrD(),
+                          child.internalChildren_.cptrD(), leafOffset[i],
+                          internalOffset[i]}));
+  }
+
+  auto ChildRoot = [&](int i) {
+    return children[i]->NumInternal() == 0 ? Leaf2Node(leafOffset[i])
+                                            : Internal2Node(internalOffset[i]);
+  };
+
+  if (numChild > 1) {
+    VecDH<Box> childBox(numChild);
+    Box sceneBox;
+    for (int i = 0; i < numChild; ++i) {
+      const int numChildLeaf = children[i]->NumLeaves();
+      childBox[i] = reduce<Box>(autoPolicy(numChildLeaf, OpKind::Reduce),
+                                leafBB.cbegin() + leafOffset[i],
+                                leafBB.cbegin() + leafOffset[i] + numChildLeaf,
+                                Box(), UnionBox());
+      sceneBox = sceneBox.Union(childBox[i]);
+    }
+    VecDH<uint32_t> childMorton(numChild);
+    VecDH<int> childNew2Old(numChild);
+    for (int i = 0; i < numChild; ++i) {
+      childMorton[i] = MortonCode(childBox[i].Center(), sceneBox);
+      childNew2Old[i] = i;
+    }
+    sort_by_key(autoPolicy(numChild, OpKind::Sort), childMorton.begin(),
+                childMorton.end(), zip(childBox.begin(), childNew2Old.begin()));
+
+    // The top tree numbers its internal nodes the same way, but its leaves
+    // must be replaced by the roots of the corresponding children.
+    const Collider top(childBox, childMorton);
+    for (int internal = 0; internal < numChild - 1; ++internal) {
+      int topChildren[2] = {top.internalChildren_[internal].first,
+                            top.internalChildren_[internal].second};
+      for (int& node : topChildren) {
+        if (IsLeaf(node)) node = ChildRoot(childNew2Old[Node2Leaf(node)]);
+        nodeParent_[node] = Internal2Node(internal);
+      }
+      internalChildren_[internal] =
+          thrust::make_pair(topChildren[0], topChildren[1]);
+    }
+  }
   UpdateBoxes(leafBB);
 }
 
@@ -314,8 +469,8 @@ void Collider::UpdateBoxes(const VecDH<Box>& leafBB) {
   // kernel over leaves to save internal Boxs
   for_each_n(
       policy, countAt(0), NumLeaves(),
-      BuildInternalBoxes({nodeBBox_.ptrD(), counter.ptrD(), nodeParent_.ptrD(),
-                          internalChildren_.ptrD()}));
+      BuildInternalBoxes({nodeBBox_.ptrD(), counter.ptrD(),
+                          nodeParent_.cptrD(), internalChildren_.cptrD()}));
 }
 
 /**
@@ -14,14 +14,20 @@
 
 #pragma once
 #include <functional>
+#include <future>
 #include <memory>
+#include <string>
+#include <unordered_map>
 
+#include "context.h"
 #include "structs.h"
+#include "trace.h"
 
 namespace manifold {
 
 class CsgNode;
 class CsgLeafNode;
+class ManifoldFuture;
 
 /** @defgroup Core
  *  @brief The central classes of the library
@@ -45,6 +51,7 @@ class Manifold {
       const std::vector<glm::ivec3>& triProperties = std::vector<glm::ivec3>(),
       const std::vector<float>& properties = std::vector<float>(),
       const std::vector<float>& propertyTolerance = std::vector<float>());
+  Manifold(const MeshView&);
 
   static Manifold Smooth(const Mesh&,
                          const std::vector<Smoothness>& sharpenedEdges = {});
@@ -89,6 +96,7 @@ class Manifold {
    */
   ///@{
   Mesh GetMesh() const;
+  void GetMesh(const MeshBuffers&) const;
   bool IsEmpty() const;
   int NumVert() const;
   int NumEdge() const;
@@ -98,6 +106,9 @@ class Manifold {
   int Genus() const;
   Properties GetProperties() const;
   Curvature GetCurvature() const;
+  int NumSelfIntersections() const;
+  std::vector<std::pair<int, int>> SelfIntersectingPairs() const;
+  std::vector<BooleanStats> GetBooleanStats() const;
   ///@}
 
   /** @name Relation
@@ -133,6 +144,8 @@ class Manifold {
    */
   enum class OpType { ADD, SUBTRACT, INTERSECT };
   Manifold Boolean(const Manifold& second, OpType op) const;
+  static Manifold BatchBoolean(const std::vector<Manifold>& manifolds,
+                               OpType op);
   // Boolean operation shorthand
   Manifold operator+(const Manifold&) const;  // ADD (Union)
   Manifold& operator+=(const Manifold&);
@@ -144,6 +157,27 @@ class Manifold {
   std::pair<Manifold, Manifold> SplitByPlane(glm::vec3 normal,
                                              float originOffset) const;
   Manifold TrimByPlane(glm::vec3 normal, float originOffset) const;
+  static std::vector<Interference> Interferences(
+      const std::vector<Manifold>& manifolds, bool calculateVolume = false);
+  ///@}
+
+  /** @name Evaluation
+   *  Control over the lazy evaluation of Boolean operations
+   */
+  ///@{
+  ManifoldFuture EvaluateAsync(
+      const ExecutionContext& context = CurrentContext()) const;
+  ///@}
+
+  /** @name Serialization
+   *  The unevaluated CSG tree as bytes, to be evaluated in another process
+   */
+  ///@{
+  std::string Serialize(
+      const std::function<bool(uint64_t)>& embedLeaf = nullptr) const;
+  static Manifold Deserialize(
+      const std::string& data,
+      std::unordered_map<uint64_t, Manifold>* leafCache = nullptr);
   ///@}
 
   /** @name Testing hooks
@@ -165,10 +199,33 @@ class Manifold {
   mutable std::shared_ptr<CsgNode> pNode_;
 
   CsgLeafNode& GetCsgLeafNode() const;
+};
 
-  static int circularSegments_;
-  static float circularAngle_;
-  static float circularEdgeLength_;
+/**
+ * A handle to a Manifold being evaluated in the background, see
+ * Manifold::EvaluateAsync(). Destroying or assigning over it before the
+ * evaluation is done cancels it and waits for it to stop.
+ */
+class ManifoldFuture {
+ public:
+  ManifoldFuture(std::future<Manifold>&& future,
+                 std::shared_ptr<Progress> progress);
+  ManifoldFuture(ManifoldFuture&&) = default;
+  ManifoldFuture& operator=(ManifoldFuture&& other);
+  ~ManifoldFuture();
+
+  bool Ready() const;
+  bool WaitFor(float seconds) const;
+  float GetProgress() const;
+  void Cancel();
+  Manifold Get();
+
+ private:
+  std::future<Manifold> future_;
+  std::shared_ptr<Progress> progress_;
 };
+
+Mesh WeldVertices(const Mesh& soup, float tolerance = 0);
+Mesh ReorderForRendering(const Mesh& mesh);
 /** @} */
 }  // namespace manifold
@@ -476,7 +476,8 @@ VecDH<int> Winding03(const Manifold::Impl &inP, SparseIndices &p0q2,
 
   auto policy = autoPolicy(p0q2.size());
   if (!is_sorted(policy, p0q2.begin(reverse), p0q2.end(reverse)))
-    sort_by_key(policy, p0q2.begin(reverse), p0q2.end(reverse), s02.begin());
+    sort_by_key(autoPolicy(p0q2.size(), OpKind::Sort), p0q2.begin(reverse),
+                p0q2.end(reverse), s02.begin());
   VecDH<int> w03val(w03.size());
   VecDH<int> w03vert(w03.size());
   // sum known s02 values into w03 (winding number)
@@ -492,23 +493,76 @@ VecDH<int> Winding03(const Manifold::Impl &inP, SparseIndices &p0q2,
               thrust::negate<int>());
   return w03;
 };
+
+/**
+ * The frame in which to carry out a Boolean: the transform of the larger
+ * operand, unless it is singular, like a zero scale, and so has no inverse.
+ */
+glm::mat4x3 BooleanFrame(const Manifold::Impl &inP,
+                         const glm::mat4x3 &transformP,
+                         const Manifold::Impl &inQ,
+                         const glm::mat4x3 &transformQ) {
+  const glm::mat4x3 &frame =
+      inP.NumVert() >= inQ.NumVert() ? transformP : transformQ;
+  const float det = glm::determinant(glm::mat3(frame));
+  if (det == 0 || !glm::isfinite(det)) return glm::mat4x3(1.0f);
+  return frame;
+}
+
+/**
+ * Returns impl, placed by transform, in the local coordinates of frame, or an
+ * empty Impl if the two are the same, in which case impl can be used as is.
+ */
+Manifold::Impl TransformInto(const glm::mat4x3 &frame,
+                             const Manifold::Impl &impl,
+                             const glm::mat4x3 &transform) {
+  if (transform == frame) return Manifold::Impl();
+  if (frame == glm::mat4x3(1.0f)) return impl.Transform(transform);
+  return impl.Transform(
+      glm::mat4x3(glm::inverse(glm::mat4(frame)) * glm::mat4(transform)));
+}
 }  // namespace
 
 namespace manifold {
 Boolean3::Boolean3(const Manifold::Impl &inP, const Manifold::Impl &inQ,
                    Manifold::OpType op)
-    : inP_(inP), inQ_(inQ), expandP_(op == Manifold::OpType::ADD ? 1.0 : -1.0) {
+    : Boolean3(inP, glm::mat4x3(1.0f), inQ, glm::mat4x3(1.0f), op) {}
+
+/**
+ * Sets up a Boolean of the operands as placed by their transforms, without
+ * applying both transforms: the smaller operand is moved into the frame of the
+ * larger one, so the larger is never copied and keeps its collider. If both
+ * share the same transform, nothing is copied at all. The result stays in that
+ * frame, given by Frame(), so it is not copied either.
+ */
+Boolean3::Boolean3(const Manifold::Impl &inP, const glm::mat4x3 &transformP,
+                   const Manifold::Impl &inQ, const glm::mat4x3 &transformQ,
+                   Manifold::OpType op)
+    : frame_(BooleanFrame(inP, transformP, inQ, transformQ)),
+      movedP_(TransformInto(frame_, inP, transformP)),
+      movedQ_(TransformInto(frame_, inQ, transformQ)),
+      inP_(transformP == frame_ ? inP : movedP_),
+      inQ_(transformQ == frame_ ? inQ : movedQ_),
+      expandP_(op == Manifold::OpType::ADD ? 1.0 : -1.0) {
   // Symbolic perturbation:
   // Union -> expand inP
   // Difference, Intersection -> contract inP
 
-  Timer broad;
+  // Each Boolean reports three steps of progress: the broad phase, the
+  // intersections and the assembly of the result in Result().
+  Checkpoint(0);
+  stats_.numTriP = inP_.NumTri();
+  stats_.numTriQ = inQ_.NumTri();
+  TraceScope trace("Boolean3");
+  Timer broad("Boolean3 broad phase");
   broad.Start();
 
-  if (inP.IsEmpty() || inQ.IsEmpty() || !inP.bBox_.DoesOverlap(inQ.bBox_)) {
+  if (inP_.IsEmpty() || inQ_.IsEmpty() ||
+      !inP_.bBox_.DoesOverlap(inQ_.bBox_)) {
     if (kVerbose) std::cout << "No overlap, early out" << std::endl;
-    w03_.resize(inP.NumVert(), 0);
-    w30_.resize(inQ.NumVert(), 0);
+    w03_.resize(inP_.NumVert(), 0);
+    w30_.resize(inQ_.NumVert(), 0);
+    Checkpoint(2);
     return;
   }
 
@@ -525,11 +579,11 @@ Boolean3::Boolean3(const Manifold::Impl &inP, const Manifold::Impl &inQ,
 
   // Level 2
   // Find vertices that overlap faces in XY-projection
-  SparseIndices p0q2 = inQ.VertexCollisionsZ(inP.vertPos_);
+  SparseIndices p0q2 = inQ_.VertexCollisionsZ(inP_.vertPos_);
   p0q2.Sort();
   if (kVerbose) std::cout << "p0q2 size = " << p0q2.size() << std::endl;
 
-  SparseIndices p2q0 = inP.VertexCollisionsZ(inQ.vertPos_);
+  SparseIndices p2q0 = inP_.VertexCollisionsZ(inQ_.vertPos_);
   p2q0.SwapPQ();
   p2q0.Sort();
   if (kVerbose) std::cout << "p2q0 size = " << p2q0.size() << std::endl;
@@ -539,7 +593,14 @@ Boolean3::Boolean3(const Manifold::Impl &inP, const Manifold::Impl &inQ,
   if (kVerbose) std::cout << "p1q1 size = " << p1q1.size() << std::endl;
 
   broad.Stop();
-  Timer intersections;
+  stats_.broadPhase = broad.Elapsed();
+  stats_.p1q2 = p1q2_.size();
+  stats_.p2q1 = p2q1_.size();
+  stats_.p0q2 = p0q2.size();
+  stats_.p2q0 = p2q0.size();
+  stats_.p1q1 = p1q1.size();
+  Checkpoint();
+  Timer intersections("Boolean3 intersections");
   intersections.Start();
 
   // Level 2
@@ -547,19 +608,19 @@ Boolean3::Boolean3(const Manifold::Impl &inP, const Manifold::Impl &inQ,
   // each edge, keeping only those whose intersection exists.
   VecDH<int> s11;
   VecDH<glm::vec4> xyzz11;
-  std::tie(s11, xyzz11) = Shadow11(p1q1, inP, inQ, expandP_);
+  std::tie(s11, xyzz11) = Shadow11(p1q1, inP_, inQ_, expandP_);
   if (kVerbose) std::cout << "s11 size = " << s11.size() << std::endl;
 
   // Build up Z-projection of vertices onto triangles, keeping only those that
   // fall inside the triangle.
   VecDH<int> s02;
   VecDH<float> z02;
-  std::tie(s02, z02) = Shadow02(inP, inQ, p0q2, true, expandP_);
+  std::tie(s02, z02) = Shadow02(inP_, inQ_, p0q2, true, expandP_);
   if (kVerbose) std::cout << "s02 size = " << s02.size() << std::endl;
 
   VecDH<int> s20;
   VecDH<float> z20;
-  std::tie(s20, z20) = Shadow02(inQ, inP, p2q0, false, expandP_);
+  std::tie(s20, z20) = Shadow02(inQ_, inP_, p2q0, false, expandP_);
   if (kVerbose) std::cout << "s20 size = " << s20.size() << std::endl;
 
   // Level 3
@@ -567,24 +628,33 @@ Boolean3::Boolean3(const Manifold::Impl &inP, const Manifold::Impl &inQ,
   // that intersect, and record the direction the edge is passing through the
   // triangle.
   std::tie(x12_, v12_) =
-      Intersect12(inP, inQ, s02, p0q2, s11, p1q1, z02, xyzz11, p1q2_, true);
+      Intersect12(inP_, inQ_, s02, p0q2, s11, p1q1, z02, xyzz11, p1q2_, true);
   if (kVerbose) std::cout << "x12 size = " << x12_.size() << std::endl;
 
   std::tie(x21_, v21_) =
-      Intersect12(inQ, inP, s20, p2q0, s11, p1q1, z20, xyzz11, p2q1_, false);
+      Intersect12(inQ_, inP_, s20, p2q0, s11, p1q1, z20, xyzz11, p2q1_, false);
   if (kVerbose) std::cout << "x21 size = " << x21_.size() << std::endl;
 
   // Sum up the winding numbers of all vertices.
-  w03_ = Winding03(inP, p0q2, s02, false);
+  w03_ = Winding03(inP_, p0q2, s02, false);
 
-  w30_ = Winding03(inQ, p2q0, s20, true);
+  w30_ = Winding03(inQ_, p2q0, s20, true);
 
   intersections.Stop();
-
-  if (kVerbose) {
-    broad.Print("Broad phase");
-    intersections.Print("Intersections");
-    MemUsage();
-  }
+  stats_.intersections = intersections.Elapsed();
+  stats_.x12 = x12_.size();
+  stats_.x21 = x21_.size();
+  stats_.tempBytesEstimate =
+      (p1q2_.size() + p2q1_.size() + p0q2.size() + p2q0.size() + p1q1.size()) *
+          2 * sizeof(int) +
+      (s11.size() + s02.size() + s20.size() + x12_.size() + x21_.size() +
+       w03_.size() + w30_.size()) *
+          sizeof(int) +
+      (z02.size() + z20.size()) * sizeof(float) +
+      xyzz11.size() * sizeof(glm::vec4) +
+      (v12_.size() + v21_.size()) * sizeof(glm::vec3);
+  Checkpoint();
+
+  if (kVerbose) MemUsage();
 }
 }  // namespace manifold
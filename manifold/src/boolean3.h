@@ -42,13 +42,30 @@ class Boolean3 {
  public:
   Boolean3(const Manifold::Impl& inP, const Manifold::Impl& inQ,
            Manifold::OpType op);
+  Boolean3(const Manifold::Impl& inP, const glm::mat4x3& transformP,
+           const Manifold::Impl& inQ, const glm::mat4x3& transformQ,
+           Manifold::OpType op);
   Manifold::Impl Result(Manifold::OpType op) const;
+  // The transform placing Result() in world space.
+  glm::mat4x3 Frame() const { return frame_; }
+  const BooleanStats& Stats() const { return stats_; }
 
  private:
+  // The operation is carried out in frame_: the transform of the larger
+  // operand, so only the smaller one is moved into it, or the identity if that
+  // transform is singular, in which case both are. The moved operands are kept
+  // in movedP_ and movedQ_, otherwise empty.
+  const glm::mat4x3 frame_;
+  const Manifold::Impl movedP_, movedQ_;
   const Manifold::Impl &inP_, &inQ_;
   const float expandP_;
   SparseIndices p1q2_, p2q1_;
   VecDH<int> x12_, x21_, w03_, w30_;
   VecDH<glm::vec3> v12_, v21_;
+  // completed by Result()
+  mutable BooleanStats stats_;
+
+  Manifold::Impl AssembleResult(Manifold::OpType op) const;
+
 };
 }  // namespace manifold
@@ -105,8 +105,8 @@ std::tuple<VecDH<int>, VecDH<int>> SizeOutput(
   VecDH<int> facePQ2R(inP.NumTri() + inQ.NumTri() + 1, 0);
   auto keepFace =
       thrust::make_transform_iterator(sidesPerFacePQ.begin(), NotZero());
-  inclusive_scan(policy, keepFace, keepFace + sidesPerFacePQ.size(),
-                 facePQ2R.begin() + 1);
+  inclusive_scan(autoPolicy(sidesPerFacePQ.size(), OpKind::Scan), keepFace,
+                 keepFace + sidesPerFacePQ.size(), facePQ2R.begin() + 1);
   int numFaceR = facePQ2R.back();
   facePQ2R.resize(inP.NumTri() + inQ.NumTri());
 
@@ -131,7 +131,8 @@ std::tuple<VecDH<int>, VecDH<int>> SizeOutput(
   auto newEnd = remove<decltype(sidesPerFacePQ.begin())>(
       policy, sidesPerFacePQ.begin(), sidesPerFacePQ.end(), 0);
   VecDH<int> faceEdge(newEnd - sidesPerFacePQ.begin() + 1, 0);
-  inclusive_scan(policy, sidesPerFacePQ.begin(), newEnd, faceEdge.begin() + 1);
+  inclusive_scan(autoPolicy(faceEdge.size(), OpKind::Scan),
+                 sidesPerFacePQ.begin(), newEnd, faceEdge.begin() + 1);
   outR.halfedge_.resize(faceEdge.back());
 
   return std::make_tuple(faceEdge, facePQ2R);
@@ -215,18 +216,20 @@ struct Ref {
   int PQ, tri, vert;
 };
 
-void AppendPartialEdges(Manifold::Impl &outR, VecDH<char> &wholeHalfedgeP,
-                        VecDH<int> &facePtrR,
+void AppendPartialEdges(Manifold::Impl &outR, char *wholeHalfedgeP,
+                        int *facePtrR,
                         std::map<int, std::vector<EdgePos>> &edgesP,
-                        VecDH<Ref> &halfedgeRef, const Manifold::Impl &inP,
+                        Ref *halfedgeRef, const Manifold::Impl &inP,
                         const VecDH<int> &i03, const VecDH<int> &vP2R,
                         const VecDH<int>::IterC faceP2R, bool forward) {
   // Each edge in the map is partially retained; for each of these, look up
   // their original verts and include them based on their winding number (i03),
   // while remaping them to the output using vP2R. Use the verts position
   // projected along the edge vector to pair them up, then distribute these
-  // edges to their faces.
-  VecDH<Halfedge> &halfedgeR = outR.halfedge_;
+  // edges to their faces. The serial loop uses raw host pointers, which skip
+  // the copy-on-write check of VecDH's mutable accessors.
+  Halfedge *halfedgeR = outR.halfedge_.ptrH();
+  const glm::vec3 *vertPosR = outR.vertPos_.cptrH();
   const VecDH<glm::vec3> &vertPosP = inP.vertPos_;
   const VecDH<Halfedge> &halfedgeP = inP.halfedge_;
 
@@ -243,13 +246,13 @@ void AppendPartialEdges(Manifold::Impl &outR, VecDH<char> &wholeHalfedgeP,
     const glm::vec3 edgeVec = vertPosP[vEnd] - vertPosP[vStart];
     // Fill in the edge positions of the old points.
     for (EdgePos &edge : edgePosP) {
-      edge.edgePos = glm::dot(outR.vertPos_[edge.vert], edgeVec);
+      edge.edgePos = glm::dot(vertPosR[edge.vert], edgeVec);
     }
 
     int inclusion = i03[vStart];
     bool reversed = inclusion < 0;
     EdgePos edgePos = {vP2R[vStart],
-                       glm::dot(outR.vertPos_[vP2R[vStart]], edgeVec),
+                       glm::dot(vertPosR[vP2R[vStart]], edgeVec),
                        inclusion > 0};
     for (int j = 0; j < glm::abs(inclusion); ++j) {
       edgePosP.push_back(edgePos);
@@ -258,7 +261,7 @@ void AppendPartialEdges(Manifold::Impl &outR, VecDH<char> &wholeHalfedgeP,
 
     inclusion = i03[vEnd];
     reversed |= inclusion < 0;
-    edgePos = {vP2R[vEnd], glm::dot(outR.vertPos_[vP2R[vEnd]], edgeVec),
+    edgePos = {vP2R[vEnd], glm::dot(vertPosR[vP2R[vEnd]], edgeVec),
                inclusion < 0};
     for (int j = 0; j < glm::abs(inclusion); ++j) {
       edgePosP.push_back(edgePos);
@@ -302,12 +305,12 @@ void AppendPartialEdges(Manifold::Impl &outR, VecDH<char> &wholeHalfedgeP,
 }
 
 void AppendNewEdges(
-    Manifold::Impl &outR, VecDH<int> &facePtrR,
+    Manifold::Impl &outR, int *facePtrR,
     std::map<std::pair<int, int>, std::vector<EdgePos>> &edgesNew,
-    VecDH<Ref> &halfedgeRef, const VecDH<int> &facePQ2R, const int numFaceP) {
+    Ref *halfedgeRef, const VecDH<int> &facePQ2R, const int numFaceP) {
   // Pair up each edge's verts and distribute to faces based on indices in key.
-  VecDH<Halfedge> &halfedgeR = outR.halfedge_;
-  VecDH<glm::vec3> &vertPosR = outR.vertPos_;
+  Halfedge *halfedgeR = outR.halfedge_.ptrH();
+  const glm::vec3 *vertPosR = outR.vertPos_.cptrH();
 
   for (auto &value : edgesNew) {
     const int faceP = value.first.first;
@@ -511,8 +514,25 @@ std::pair<VecDH<BaryRef>, VecDH<int>> CalculateMeshRelation(
 
 namespace manifold {
 
+/**
+ * Returns the result of the operation in the frame given by Frame(), which
+ * places it in world space. This completes Stats(), which are also passed to
+ * the onBoolean callback of the current ExecutionContext.
+ */
 Manifold::Impl Boolean3::Result(Manifold::OpType op) const {
-  Timer assemble;
+  TraceScope trace("Boolean3::Result");
+  Checkpoint(0);
+  Manifold::Impl result = AssembleResult(op);
+  stats_.numVert = result.NumVert();
+  stats_.numTri = result.NumTri();
+  const auto& onBoolean = CurrentContext().onBoolean;
+  if (onBoolean) onBoolean(stats_);
+  Checkpoint();
+  return result;
+}
+
+Manifold::Impl Boolean3::AssembleResult(Manifold::OpType op) const {
+  Timer assemble("Result assembly");
   assemble.Start();
 
   if ((expandP_ > 0) != (op == Manifold::OpType::ADD))
@@ -571,28 +591,29 @@ Manifold::Impl Boolean3::Result(Manifold::OpType op) const {
   transform(policy, w30_.begin(), w30_.end(), i30.begin(), c2 + c3 * _1);
 
   VecDH<int> vP2R(inP_.NumVert());
-  exclusive_scan(policy, i03.begin(), i03.end(), vP2R.begin(), 0, AbsSum());
+  exclusive_scan(autoPolicy(i03.size(), OpKind::Scan), i03.begin(), i03.end(),
+                 vP2R.begin(), 0, AbsSum());
   int numVertR = AbsSum()(vP2R.back(), i03.back());
   const int nPv = numVertR;
 
   VecDH<int> vQ2R(inQ_.NumVert());
-  exclusive_scan(policy, i30.begin(), i30.end(), vQ2R.begin(), numVertR,
-                 AbsSum());
+  exclusive_scan(autoPolicy(i30.size(), OpKind::Scan), i30.begin(), i30.end(),
+                 vQ2R.begin(), numVertR, AbsSum());
   numVertR = AbsSum()(vQ2R.back(), i30.back());
   const int nQv = numVertR - nPv;
 
   VecDH<int> v12R(v12_.size());
   if (v12_.size() > 0) {
-    exclusive_scan(policy, i12.begin(), i12.end(), v12R.begin(), numVertR,
-                   AbsSum());
+    exclusive_scan(autoPolicy(i12.size(), OpKind::Scan), i12.begin(),
+                   i12.end(), v12R.begin(), numVertR, AbsSum());
     numVertR = AbsSum()(v12R.back(), i12.back());
   }
   const int n12 = numVertR - nPv - nQv;
 
   VecDH<int> v21R(v21_.size());
   if (v21_.size() > 0) {
-    exclusive_scan(policy, i21.begin(), i21.end(), v21R.begin(), numVertR,
-                   AbsSum());
+    exclusive_scan(autoPolicy(i21.size(), OpKind::Scan), i21.begin(),
+                   i21.end(), v21R.begin(), numVertR, AbsSum());
     numVertR = AbsSum()(v21R.back(), i21.back());
   }
   const int n21 = numVertR - nPv - nQv - n12;
@@ -655,13 +676,15 @@ Manifold::Impl Boolean3::Result(Manifold::OpType op) const {
   // are triangulated.
   VecDH<Ref> halfedgeRef(2 * outR.NumEdge());
 
-  AppendPartialEdges(outR, wholeHalfedgeP, facePtrR, edgesP, halfedgeRef, inP_,
-                     i03, vP2R, facePQ2R.begin(), true);
-  AppendPartialEdges(outR, wholeHalfedgeQ, facePtrR, edgesQ, halfedgeRef, inQ_,
-                     i30, vQ2R, facePQ2R.begin() + inP_.NumTri(), false);
+  AppendPartialEdges(outR, wholeHalfedgeP.ptrH(), facePtrR.ptrH(), edgesP,
+                     halfedgeRef.ptrH(), inP_, i03, vP2R, facePQ2R.cbegin(),
+                     true);
+  AppendPartialEdges(outR, wholeHalfedgeQ.ptrH(), facePtrR.ptrH(), edgesQ,
+                     halfedgeRef.ptrH(), inQ_, i30, vQ2R,
+                     facePQ2R.cbegin() + inP_.NumTri(), false);
 
-  AppendNewEdges(outR, facePtrR, edgesNew, halfedgeRef, facePQ2R,
-                 inP_.NumTri());
+  AppendNewEdges(outR, facePtrR.ptrH(), edgesNew, halfedgeRef.ptrH(),
+                 facePQ2R, inP_.NumTri());
 
   AppendWholeEdges(outR, facePtrR, halfedgeRef, inP_, wholeHalfedgeP, i03, vP2R,
                    facePQ2R.cptrD(), true);
@@ -674,7 +697,8 @@ Manifold::Impl Boolean3::Result(Manifold::OpType op) const {
       outR, halfedgeRef, inP_, inQ_, nPv + nQv, numFaceR, invertQ);
 
   assemble.Stop();
-  Timer triangulate;
+  Checkpoint(0);
+  Timer triangulate("Result triangulation");
   triangulate.Start();
 
   // Level 6
@@ -682,7 +706,7 @@ Manifold::Impl Boolean3::Result(Manifold::OpType op) const {
   outR.Face2Tri(faceEdge, faceRef, halfedgeBary);
 
   triangulate.Stop();
-  Timer simplify;
+  Timer simplify("Result simplification");
   simplify.Start();
 
   outR.SimplifyTopology();
@@ -702,17 +726,17 @@ Manifold::Impl Boolean3::Result(Manifold::OpType op) const {
   outR.UpdateMeshIDs(meshIDs, original);
 
   simplify.Stop();
-  Timer sort;
+  Timer sort("Result sorting");
   sort.Start();
 
   outR.Finish();
 
   sort.Stop();
+  stats_.assembly = assemble.Elapsed();
+  stats_.triangulation = triangulate.Elapsed();
+  stats_.simplification = simplify.Elapsed();
+  stats_.sorting = sort.Elapsed();
   if (kVerbose) {
-    assemble.Print("Assembly");
-    triangulate.Print("Triangulation");
-    simplify.Print("Simplification");
-    sort.Print("Sorting");
     std::cout << outR.NumVert() << " verts and " << outR.NumTri() << " tris"
               << std::endl;
   }
@@ -347,14 +347,20 @@ Manifold Manifold::Revolve(const Polygons& crossSection, int circularSegments) {
  * topological operation, so care should be taken to avoid creating
  * overlapping results. It is the inverse operation of Decompose().
  *
+ * The result is instanced: the inputs keep sharing their geometry, and
+ * transforms and bounding box queries apply to each of them, until the
+ * combined mesh is actually needed. Booleans only materialize the instances
+ * they cut, so patterning one part many times stays cheap.
+ *
  * @param manifolds A vector of Manifolds to lazy-union together.
  */
 Manifold Manifold::Compose(const std::vector<Manifold>& manifolds) {
+  if (manifolds.empty()) return Manifold();
   std::vector<std::shared_ptr<CsgLeafNode>> children;
   for (const auto& manifold : manifolds) {
-    children.push_back(manifold.pNode_->ToLeafNode());
+    children.push_back(std::atomic_load(&manifold.pNode_)->ToLeafNode());
   }
-  return Manifold(std::make_shared<Impl>(CsgLeafNode::Compose(children)));
+  return Manifold(std::make_shared<CsgLeafNode>(children));
 }
 
 /**
@@ -363,6 +369,17 @@ Manifold Manifold::Compose(const std::vector<Manifold>& manifolds) {
  * containing a copy of the original. It is the inverse operation of Compose().
  */
 std::vector<Manifold> Manifold::Decompose() const {
+  const std::vector<std::shared_ptr<CsgLeafNode>> instances =
+      GetCsgLeafNode().GetInstances();
+  if (!instances.empty()) {
+    std::vector<Manifold> meshes;
+    for (const auto& instance : instances) {
+      std::vector<Manifold> parts = Manifold(instance).Decompose();
+      meshes.insert(meshes.end(), parts.begin(), parts.end());
+    }
+    return meshes;
+  }
+
   Graph graph;
   auto pImpl_ = GetCsgLeafNode().GetImpl();
   for (int i = 0; i < NumVert(); ++i) {
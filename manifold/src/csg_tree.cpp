@@ -14,6 +14,8 @@
 
 #include "csg_tree.h"
 
+#include <thrust/transform_reduce.h>
+
 #include <algorithm>
 
 #include "boolean3.h"
@@ -64,6 +66,32 @@ struct UpdateHalfedge {
   }
 };
 
+struct TransformedBox {
+  const glm::mat4x3 transform;
+
+  __host__ __device__ Box operator()(glm::vec3 position) {
+    const glm::vec3 pos = transform * glm::vec4(position, 1.0f);
+    return Box(pos, pos);
+  }
+};
+
+struct UnionBox : public thrust::binary_function<Box, Box, Box> {
+  __host__ __device__ Box operator()(const Box &a, const Box &b) {
+    return a.Union(b);
+  }
+};
+
+bool IsAxisAligned(const glm::mat4x3 &transform) {
+  for (int row : {0, 1, 2}) {
+    int count = 0;
+    for (int col : {0, 1, 2}) {
+      if (transform[col][row] == 0.0f) ++count;
+    }
+    if (count != 2) return false;
+  }
+  return true;
+}
+
 struct CheckOverlap {
   const Box *boxes;
   const size_t i;
@@ -110,26 +138,132 @@ CsgLeafNode::CsgLeafNode(std::shared_ptr<const Manifold::Impl> pImpl_,
                          glm::mat4x3 transform_)
     : pImpl_(pImpl_), transform_(transform_) {}
 
+CsgLeafNode::CsgLeafNode(
+    const std::vector<std::shared_ptr<CsgLeafNode>> &instances) {
+  for (auto &node : instances) {
+    if (node->instances_.empty()) {
+      instances_.push_back(node);
+    } else {
+      instances_.insert(instances_.end(), node->instances_.begin(),
+                        node->instances_.end());
+    }
+  }
+  if (instances_.empty()) pImpl_ = std::make_shared<Manifold::Impl>();
+}
+
+/**
+ * Returns the Impl with this node's transform applied, or the composition of
+ * its instances. This is computed only once: concurrent callers wait for the
+ * first one to finish, and later calls return the cached result lock-free.
+ */
 std::shared_ptr<const Manifold::Impl> CsgLeafNode::GetImpl() const {
-  if (transform_ == glm::mat4x3(1.0f)) return pImpl_;
-  pImpl_ =
-      std::make_shared<const Manifold::Impl>(pImpl_->Transform(transform_));
-  transform_ = glm::mat4x3(1.0f);
-  return pImpl_;
+  if (instances_.empty() && transform_ == glm::mat4x3(1.0f)) return pImpl_;
+  std::shared_ptr<const Manifold::Impl> cache = std::atomic_load(&cache_);
+  if (cache != nullptr) return cache;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  cache = std::atomic_load(&cache_);
+  if (cache != nullptr) return cache;
+  if (!instances_.empty()) {
+    cache = std::make_shared<const Manifold::Impl>(Compose(instances_));
+  } else {
+    cache =
+        std::make_shared<const Manifold::Impl>(pImpl_->Transform(transform_));
+  }
+  std::atomic_store(&cache_, cache);
+  return cache;
 }
 
 glm::mat4x3 CsgLeafNode::GetTransform() const { return transform_; }
 
+/**
+ * Returns the Impl without this node's transform applied, which is then given
+ * by GetTransform(). This avoids copying the mesh when the consumer, like
+ * Boolean3, can handle the transform itself.
+ */
+std::shared_ptr<const Manifold::Impl> CsgLeafNode::GetBaseImpl() const {
+  if (!instances_.empty()) return GetImpl();
+  return pImpl_;
+}
+
+/**
+ * Returns the instances of an instanced leaf, otherwise an empty vector. They
+ * are kept after GetImpl() has composed them.
+ */
+const std::vector<std::shared_ptr<CsgLeafNode>> &CsgLeafNode::GetInstances()
+    const {
+  return instances_;
+}
+
+/**
+ * Returns the statistics of the Boolean operations that were evaluated to
+ * produce this node, in the order they ran.
+ */
+const std::vector<BooleanStats> &CsgLeafNode::GetBooleanStats() const {
+  static const std::vector<BooleanStats> none;
+  return stats_ == nullptr ? none : *stats_;
+}
+
+/**
+ * Only for nodes that are not yet shared.
+ */
+void CsgLeafNode::SetBooleanStats(std::vector<BooleanStats> &&stats) {
+  stats_ = stats.empty() ? nullptr
+                         : std::make_shared<const std::vector<BooleanStats>>(
+                               std::move(stats));
+}
+
+/**
+ * The exact bounding box after the transform, found without applying it. For
+ * an instanced leaf this is the union of its instances' boxes. It is computed
+ * only once, as the broad phase of a Boolean asks for it repeatedly.
+ */
 Box CsgLeafNode::GetBoundingBox() const {
-  return pImpl_->bBox_.Transform(transform_);
+  std::call_once(bBoxOnce_, [this]() { bBox_ = CalculateBoundingBox(); });
+  return bBox_;
+}
+
+Box CsgLeafNode::CalculateBoundingBox() const {
+  if (!instances_.empty()) {
+    Box box;
+    for (auto &instance : instances_) {
+      box = box.Union(instance->GetBoundingBox());
+    }
+    return box;
+  }
+  if (IsAxisAligned(transform_)) return pImpl_->bBox_.Transform(transform_);
+  return transform_reduce<Box>(
+      autoPolicy(pImpl_->NumVert(), OpKind::Reduce), pImpl_->vertPos_.cbegin(),
+      pImpl_->vertPos_.cend(), TransformedBox({transform_}), Box(), UnionBox());
 }
 
 std::shared_ptr<CsgLeafNode> CsgLeafNode::ToLeafNode() const {
-  return std::make_shared<CsgLeafNode>(*this);
+  auto node = std::make_shared<CsgLeafNode>(pImpl_, transform_);
+  node->instances_ = instances_;
+  node->stats_ = stats_;
+  node->cache_ = std::atomic_load(&cache_);
+  return node;
 }
 
+/**
+ * Transforms of an instanced leaf are pushed down to its instances, so their
+ * geometry is still shared rather than copied.
+ */
 std::shared_ptr<CsgNode> CsgLeafNode::Transform(const glm::mat4x3 &m) const {
-  return std::make_shared<CsgLeafNode>(pImpl_, m * glm::mat4(transform_));
+  if (!instances_.empty()) {
+    std::vector<std::shared_ptr<CsgLeafNode>> instances;
+    instances.reserve(instances_.size());
+    for (auto &instance : instances_) {
+      instances.push_back(std::make_shared<CsgLeafNode>(
+          instance->pImpl_, m * glm::mat4(instance->transform_)));
+    }
+    auto node = std::make_shared<CsgLeafNode>(instances);
+    node->stats_ = stats_;
+    return node;
+  }
+  auto node = std::make_shared<CsgLeafNode>(pImpl_, m * glm::mat4(transform_));
+  node->stats_ = stats_;
+  return node;
 }
 
 CsgNodeType CsgLeafNode::GetNodeType() const { return CsgNodeType::LEAF; }
@@ -138,7 +272,19 @@ CsgNodeType CsgLeafNode::GetNodeType() const { return CsgNodeType::LEAF; }
  * Efficient union of a set of pairwise disjoint meshes.
  */
 Manifold::Impl CsgLeafNode::Compose(
-    const std::vector<std::shared_ptr<CsgLeafNode>> &nodes) {
+    const std::vector<std::shared_ptr<CsgLeafNode>> &nodesIn) {
+  TraceScope trace("Compose");
+  // expand any instanced leaves into their instances
+  std::vector<std::shared_ptr<CsgLeafNode>> nodes;
+  for (auto &node : nodesIn) {
+    if (node->instances_.empty()) {
+      nodes.push_back(node);
+    } else {
+      nodes.insert(nodes.end(), node->instances_.begin(),
+                   node->instances_.end());
+    }
+  }
+
   float precision = -1;
   int numVert = 0;
   int numEdge = 0;
@@ -230,7 +376,9 @@ Manifold::Impl CsgLeafNode::Compose(
   }
   // required to remove parts that are smaller than the precision
   combined.SimplifyTopology();
-  combined.Finish();
+  std::vector<const Collider *> colliders;
+  for (auto &node : nodes) colliders.push_back(&node->pImpl_->collider_);
+  if (!combined.FinishComposed(colliders)) combined.Finish();
   return combined;
 }
 
@@ -242,6 +390,8 @@ CsgOpNode::CsgOpNode(const std::vector<std::shared_ptr<CsgNode>> &children,
   SetOp(op);
   // opportunisticly flatten the tree without costly evaluation
   GetChildren(false);
+  original_ =
+      std::make_shared<const std::vector<std::shared_ptr<CsgNode>>>(children_);
 }
 
 CsgOpNode::CsgOpNode(std::vector<std::shared_ptr<CsgNode>> &&children,
@@ -250,23 +400,54 @@ CsgOpNode::CsgOpNode(std::vector<std::shared_ptr<CsgNode>> &&children,
   SetOp(op);
   // opportunisticly flatten the tree without costly evaluation
   GetChildren(false);
+  original_ =
+      std::make_shared<const std::vector<std::shared_ptr<CsgNode>>>(children_);
 }
 
+/**
+ * Never waits on an evaluation of this node: the copy takes its result if it is
+ * done, or else its children as they stand, or while it runs, the original
+ * children.
+ */
 std::shared_ptr<CsgNode> CsgOpNode::Transform(const glm::mat4x3 &m) const {
+  std::shared_ptr<CsgLeafNode> cache = std::atomic_load(&cache_);
+  if (cache != nullptr) return cache->Transform(m);
+
   auto node = std::make_shared<CsgOpNode>();
-  node->children_ = children_;
   node->op_ = op_;
   node->transform_ = m * glm::mat4(transform_);
-  node->simplified_ = simplified_;
-  node->flattened_ = flattened_;
+  node->original_ = std::atomic_load(&original_);
+  std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+  if (lock.owns_lock()) {
+    node->children_ = children_;
+    node->simplified_ = simplified_;
+    node->flattened_ = flattened_;
+  } else if (node->original_ != nullptr) {
+    node->children_ = *node->original_;
+  } else {
+    // the evaluation finished in the meantime
+    return std::atomic_load(&cache_)->Transform(m);
+  }
   return node;
 }
 
+/**
+ * Evaluates this node once. Concurrent callers block on mutex_ until the first
+ * one has published cache_, so they all share the same result, which later
+ * calls read without locking.
+ */
 std::shared_ptr<CsgLeafNode> CsgOpNode::ToLeafNode() const {
-  if (cache_ != nullptr) return cache_;
+  std::shared_ptr<CsgLeafNode> cache = std::atomic_load(&cache_);
+  if (cache != nullptr) return cache;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  cache = std::atomic_load(&cache_);
+  if (cache != nullptr) return cache;
   if (children_.empty()) return nullptr;
+  TraceScope trace("CSG evaluation");
   // turn the children into leaf nodes
-  GetChildren();
+  std::vector<BooleanStats> stats;
+  GetChildren(true, &stats);
   Manifold::OpType op;
   switch (op_) {
     case CsgNodeType::UNION:
@@ -282,33 +463,136 @@ std::shared_ptr<CsgLeafNode> CsgOpNode::ToLeafNode() const {
       throw std::runtime_error("unreachable CSG operation");
       break;
   }
-  auto a = std::static_pointer_cast<CsgLeafNode>(children_[0])->GetImpl();
-  for (int i = 1; i < children_.size(); i++) {
-    auto b = std::static_pointer_cast<CsgLeafNode>(children_[i])->GetImpl();
-    Boolean3 boolean(*a, *b, op);
-    a = std::make_shared<Manifold::Impl>(boolean.Result(op));
+  if (children_.size() == 1) {
+    cache = std::dynamic_pointer_cast<CsgLeafNode>(
+        children_.front()->Transform(transform_));
+    cache->SetBooleanStats(std::move(stats));
+    std::atomic_store(&cache_, cache);
+    ReleaseOriginal();
+    return cache;
+  }
+  // children_ is only replaced once done, so a canceled evaluation can be
+  // resumed later
+  std::vector<std::shared_ptr<CsgNode>> children = children_;
+  std::vector<std::shared_ptr<CsgLeafNode>> untouched =
+      SetAsideInstances(children);
+  std::vector<std::shared_ptr<CsgLeafNode>> leaves;
+  for (auto &child : children)
+    leaves.push_back(std::static_pointer_cast<CsgLeafNode>(child));
+  std::shared_ptr<CsgLeafNode> result;
+  if (op == Manifold::OpType::ADD) {
+    result = BatchUnion(leaves, stats);
+  } else if (op == Manifold::OpType::INTERSECT) {
+    result = BatchBoolean(op, leaves, stats);
+  } else {
+    // first - (second + third + ...)
+    std::shared_ptr<CsgLeafNode> first = leaves.front();
+    leaves.erase(leaves.begin());
+    result = SimpleBoolean(*first, *BatchUnion(leaves, stats), op, stats);
   }
   children_.clear();
-  children_.push_back(std::make_shared<CsgLeafNode>(a));
+  if (untouched.empty()) {
+    children_.push_back(result);
+  } else {
+    untouched.push_back(result);
+    children_.push_back(std::make_shared<CsgLeafNode>(untouched));
+  }
   // children_ must contain only one CsgLeafNode now, and its Transform will
   // give CsgLeafNode as well
-  cache_ = std::dynamic_pointer_cast<CsgLeafNode>(
+  cache = std::dynamic_pointer_cast<CsgLeafNode>(
       children_.front()->Transform(transform_));
-  return cache_;
+  cache->SetBooleanStats(std::move(stats));
+  std::atomic_store(&cache_, cache);
+  ReleaseOriginal();
+  return cache;
+}
+
+/**
+ * Once cache_ is published, Transform() no longer needs the original children,
+ * so their meshes can be freed.
+ */
+void CsgOpNode::ReleaseOriginal() const {
+  std::atomic_store(
+      &original_,
+      std::shared_ptr<const std::vector<std::shared_ptr<CsgNode>>>());
+}
+
+/**
+ * Removes the instances of instanced children that this operation cannot
+ * change, so that only those it actually cuts get materialized. Instances of
+ * any child of a union, or of the first child of a difference, whose boxes
+ * overlap no other child are returned to be added back to the result as they
+ * are. Instances of an intersection's children that miss any other child are
+ * dropped.
+ */
+std::vector<std::shared_ptr<CsgLeafNode>> CsgOpNode::SetAsideInstances(
+    std::vector<std::shared_ptr<CsgNode>> &children) const {
+  // INVARIANT: children is a vector of leaf nodes
+  std::vector<std::shared_ptr<CsgLeafNode>> untouched;
+  const int numChildren = children.size();
+  std::vector<Box> boxes;
+  for (auto &child : children) {
+    boxes.push_back(
+        std::static_pointer_cast<CsgLeafNode>(child)->GetBoundingBox());
+  }
+  const bool intersect = op_ == CsgNodeType::INTERSECTION;
+  const int numTargets = op_ == CsgNodeType::DIFFERENCE ? 1 : numChildren;
+  for (int i = 0; i < numTargets; ++i) {
+    const auto &instances =
+        std::static_pointer_cast<CsgLeafNode>(children[i])->GetInstances();
+    if (instances.empty()) continue;
+    std::vector<std::shared_ptr<CsgLeafNode>> touched;
+    for (auto &instance : instances) {
+      const Box box = instance->GetBoundingBox();
+      bool cut = intersect;
+      for (int j = 0; j < numChildren; ++j) {
+        if (j == i) continue;
+        if (intersect) {
+          cut &= box.DoesOverlap(boxes[j]);
+        } else {
+          cut |= box.DoesOverlap(boxes[j]);
+        }
+      }
+      if (cut) {
+        touched.push_back(instance);
+      } else if (!intersect) {
+        untouched.push_back(instance);
+      }
+    }
+    children[i] = std::make_shared<CsgLeafNode>(touched);
+  }
+  return untouched;
+}
+
+/**
+ * Applies one Boolean3 to two leaves. The result stays in the Boolean's frame,
+ * to be transformed lazily.
+ */
+std::shared_ptr<CsgLeafNode> CsgOpNode::SimpleBoolean(
+    const CsgLeafNode &a, const CsgLeafNode &b, Manifold::OpType operation,
+    std::vector<BooleanStats> &stats) {
+  Boolean3 boolean(*a.GetBaseImpl(), a.GetTransform(), *b.GetBaseImpl(),
+                   b.GetTransform(), operation);
+  auto pImpl =
+      std::make_shared<const Manifold::Impl>(boolean.Result(operation));
+  stats.push_back(boolean.Stats());
+  return std::make_shared<CsgLeafNode>(pImpl, boolean.Frame());
 }
 
 /**
  * Efficient boolean operation on a set of nodes utilizing commutativity of the
  * operation. Only supports union and intersection.
  */
-void CsgOpNode::BatchBoolean(
+std::shared_ptr<CsgLeafNode> CsgOpNode::BatchBoolean(
     Manifold::OpType operation,
-    std::vector<std::shared_ptr<const Manifold::Impl>> &results) {
+    std::vector<std::shared_ptr<CsgLeafNode>> &results,
+    std::vector<BooleanStats> &stats) {
   assert(operation != Manifold::OpType::SUBTRACT);
-  auto cmpFn = [](std::shared_ptr<const Manifold::Impl> a,
-                  std::shared_ptr<const Manifold::Impl> b) {
+  TraceScope trace("BatchBoolean");
+  auto cmpFn = [](const std::shared_ptr<CsgLeafNode> &a,
+                  const std::shared_ptr<CsgLeafNode> &b) {
     // invert the order because we want a min heap
-    return a->NumVert() > b->NumVert();
+    return a->GetBaseImpl()->NumVert() > b->GetBaseImpl()->NumVert();
   };
 
   // apply boolean operations starting from smaller meshes
@@ -316,44 +600,44 @@ void CsgOpNode::BatchBoolean(
   // due to less data being copied and processed
   std::make_heap(results.begin(), results.end(), cmpFn);
   while (results.size() > 1) {
+    Checkpoint(0);
     std::pop_heap(results.begin(), results.end(), cmpFn);
     auto a = std::move(results.back());
     results.pop_back();
     std::pop_heap(results.begin(), results.end(), cmpFn);
     auto b = std::move(results.back());
     results.pop_back();
-    // boolean operation
-    Boolean3 boolean(*a, *b, operation);
-    results.push_back(
-        std::make_shared<const Manifold::Impl>(boolean.Result(operation)));
+    results.push_back(SimpleBoolean(*a, *b, operation, stats));
     std::push_heap(results.begin(), results.end(), cmpFn);
   }
+  return results.front();
 }
 
 /**
  * Efficient union operation on a set of nodes by doing Compose as much as
- * possible.
+ * possible: children whose bounding boxes are pairwise disjoint are composed
+ * into one, and the resulting sets are unioned by BatchBoolean().
  */
-void CsgOpNode::BatchUnion() const {
-  // INVARIANT: children_ is a vector of leaf nodes
+std::shared_ptr<CsgLeafNode> CsgOpNode::BatchUnion(
+    std::vector<std::shared_ptr<CsgLeafNode>> &children,
+    std::vector<BooleanStats> &stats) {
+  TraceScope trace("BatchUnion");
   // this kMaxUnionSize is a heuristic to avoid the pairwise disjoint check
   // with O(n^2) complexity to take too long.
   // If the number of children exceeded this limit, we will operate on chunks
   // with size kMaxUnionSize.
   constexpr int kMaxUnionSize = 1000;
-  while (children_.size() > 1) {
+  while (children.size() > 1) {
     int start;
-    if (children_.size() > kMaxUnionSize) {
-      start = children_.size() - kMaxUnionSize;
+    if (children.size() > kMaxUnionSize) {
+      start = children.size() - kMaxUnionSize;
     } else {
       start = 0;
     }
     VecDH<Box> boxes;
-    boxes.reserve(children_.size() - start);
-    for (int i = start; i < children_.size(); i++) {
-      boxes.push_back(std::dynamic_pointer_cast<CsgLeafNode>(children_[i])
-                          ->GetBoundingBox());
-    }
+    boxes.reserve(children.size() - start);
+    for (int i = start; i < children.size(); i++)
+      boxes.push_back(children[i]->GetBoundingBox());
     const Box *boxesD = boxes.cptrD();
     // partition the children into a set of disjoint sets
     // each set contains a set of children that are pairwise disjoint
@@ -373,29 +657,27 @@ void CsgOpNode::BatchUnion() const {
       }
     }
     // compose each set of disjoint children
-    std::vector<std::shared_ptr<const Manifold::Impl>> impls;
+    std::vector<std::shared_ptr<CsgLeafNode>> composed;
     for (const auto &set : disjointSets) {
       if (set.size() == 1) {
-        impls.push_back(
-            std::dynamic_pointer_cast<CsgLeafNode>(children_[start + set[0]])
-                ->GetImpl());
+        composed.push_back(children[start + set[0]]);
       } else {
         std::vector<std::shared_ptr<CsgLeafNode>> tmp;
-        for (size_t j : set) {
-          tmp.push_back(
-              std::dynamic_pointer_cast<CsgLeafNode>(children_[start + j]));
-        }
-        impls.push_back(
-            std::make_shared<const Manifold::Impl>(CsgLeafNode::Compose(tmp)));
+        for (size_t j : set) tmp.push_back(children[start + j]);
+        composed.push_back(std::make_shared<CsgLeafNode>(
+            std::make_shared<const Manifold::Impl>(
+                CsgLeafNode::Compose(tmp))));
       }
     }
-    BatchBoolean(Manifold::OpType::ADD, impls);
-    children_.erase(children_.begin() + start, children_.end());
-    children_.push_back(std::make_shared<CsgLeafNode>(impls.back()));
+    std::shared_ptr<CsgLeafNode> result =
+        BatchBoolean(Manifold::OpType::ADD, composed, stats);
+    children.erase(children.begin() + start, children.end());
+    children.push_back(result);
     // move it to the front as we process from the back, and the newly added
     // child should be quite complicated
-    std::swap(children_.front(), children_.back());
+    std::swap(children.front(), children.back());
   }
+  return children.front();
 }
 
 /**
@@ -406,11 +688,10 @@ void CsgOpNode::BatchUnion() const {
  * be shared with other nodes.
  */
 std::vector<std::shared_ptr<CsgNode>> &CsgOpNode::GetChildren(
-    bool finalize) const {
+    bool finalize, std::vector<BooleanStats> *stats) const {
   if (children_.empty() || (simplified_ && !finalize) || flattened_)
     return children_;
-  simplified_ = true;
-  flattened_ = finalize;
+  TraceScope trace("CSG flattening");
   std::vector<std::shared_ptr<CsgNode>> newChildren;
 
   CsgNodeType op = op_;
@@ -418,13 +699,21 @@ std::vector<std::shared_ptr<CsgNode>> &CsgOpNode::GetChildren(
     if (!finalize || child->GetNodeType() == CsgNodeType::LEAF) {
       newChildren.push_back(child);
     } else {
-      newChildren.push_back(child->ToLeafNode());
+      auto leaf = child->ToLeafNode();
+      if (stats != nullptr) {
+        const std::vector<BooleanStats> &childStats = leaf->GetBooleanStats();
+        stats->insert(stats->end(), childStats.begin(), childStats.end());
+      }
+      newChildren.push_back(leaf);
     }
     // special handling for difference: we treat it as first - (second + third +
     // ...) so op = UNION after the first node
     if (op == CsgNodeType::DIFFERENCE) op = CsgNodeType::UNION;
   }
+  // only marked once done, so a canceled evaluation can be resumed later
   children_ = newChildren;
+  simplified_ = true;
+  flattened_ = finalize;
   return children_;
 }
 
@@ -444,4 +733,29 @@ void CsgOpNode::SetOp(Manifold::OpType op) {
 
 glm::mat4x3 CsgOpNode::GetTransform() const { return transform_; }
 
+/**
+ * An upper bound on the number of Boolean3 operations left to evaluate this
+ * node, used to report progress.
+ */
+int CsgOpNode::NumPendingBooleans() const {
+  if (std::atomic_load(&cache_) != nullptr) return 0;
+  // don't wait on an evaluation that is already running
+  std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+  if (!lock.owns_lock()) return 1;
+  if (children_.empty()) return 0;
+  int num = children_.size() - 1;
+  for (auto &child : children_) num += child->NumPendingBooleans();
+  return num;
+}
+
+/**
+ * A copy of the children as they stand, without evaluating anything. Once this
+ * node is evaluated, that is the single leaf holding its result before
+ * transform_, which describes the same solid. Waits for a running evaluation.
+ */
+std::vector<std::shared_ptr<CsgNode>> CsgOpNode::GetPendingChildren() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return children_;
+}
+
 }  // namespace manifold
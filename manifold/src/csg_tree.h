@@ -1,4 +1,6 @@
 #pragma once
+#include <mutex>
+
 #include "manifold.h"
 
 namespace manifold {
@@ -13,6 +15,7 @@ class CsgNode {
   virtual std::shared_ptr<CsgNode> Transform(const glm::mat4x3 &m) const = 0;
   virtual CsgNodeType GetNodeType() const = 0;
   virtual glm::mat4x3 GetTransform() const = 0;
+  virtual int NumPendingBooleans() const { return 0; }
 
   std::shared_ptr<CsgNode> Translate(const glm::vec3 &t) const;
   std::shared_ptr<CsgNode> Scale(const glm::vec3 &s) const;
@@ -26,8 +29,17 @@ class CsgLeafNode final : public CsgNode {
   CsgLeafNode(std::shared_ptr<const Manifold::Impl> pImpl_);
   CsgLeafNode(std::shared_ptr<const Manifold::Impl> pImpl_,
               glm::mat4x3 transform_);
+  // An instanced leaf: the disjoint composition of these nodes, which keep
+  // sharing their geometry until GetImpl() is called.
+  CsgLeafNode(const std::vector<std::shared_ptr<CsgLeafNode>> &instances);
 
   std::shared_ptr<const Manifold::Impl> GetImpl() const;
+  std::shared_ptr<const Manifold::Impl> GetBaseImpl() const;
+
+  const std::vector<std::shared_ptr<CsgLeafNode>> &GetInstances() const;
+
+  const std::vector<BooleanStats> &GetBooleanStats() const;
+  void SetBooleanStats(std::vector<BooleanStats> &&stats);
 
   Box GetBoundingBox() const;
 
@@ -43,8 +55,21 @@ class CsgLeafNode final : public CsgNode {
       const std::vector<std::shared_ptr<CsgLeafNode>> &nodes);
 
  private:
-  mutable std::shared_ptr<const Manifold::Impl> pImpl_;
-  mutable glm::mat4x3 transform_ = glm::mat4x3(1.0f);
+  std::shared_ptr<const Manifold::Impl> pImpl_;
+  glm::mat4x3 transform_ = glm::mat4x3(1.0f);
+  // non-empty only for instanced leaves
+  std::vector<std::shared_ptr<CsgLeafNode>> instances_;
+  // the Booleans that produced this node, shared by its transformed copies
+  std::shared_ptr<const std::vector<BooleanStats>> stats_;
+  // the transformed or composed Impl, computed once under mutex_ and then
+  // read lock-free through std::atomic_load
+  mutable std::shared_ptr<const Manifold::Impl> cache_;
+  mutable std::mutex mutex_;
+  // the box after transform_, computed once by GetBoundingBox()
+  mutable Box bBox_;
+  mutable std::once_flag bBoxOnce_;
+
+  Box CalculateBoundingBox() const;
 };
 
 class CsgOpNode final : public CsgNode {
@@ -65,25 +90,47 @@ class CsgOpNode final : public CsgNode {
 
   glm::mat4x3 GetTransform() const override;
 
+  int NumPendingBooleans() const override;
+
+  std::vector<std::shared_ptr<CsgNode>> GetPendingChildren() const;
+
  private:
   CsgNodeType op_;
   glm::mat4x3 transform_ = glm::mat4x3(1.0f);
-  // the following fields are for lazy evaluation, so they are mutable
+  // the following fields are for lazy evaluation, so they are mutable; they
+  // are only touched under mutex_, except that the finished cache_ is read
+  // lock-free through std::atomic_load
   mutable std::vector<std::shared_ptr<CsgNode>> children_;
   mutable std::shared_ptr<CsgLeafNode> cache_ = nullptr;
   mutable bool simplified_ = false;
   mutable bool flattened_ = false;
+  mutable std::mutex mutex_;
+  // the children as constructed, which Transform() copies rather than wait on
+  // mutex_ while an evaluation holds it; read and released atomically
+  mutable std::shared_ptr<const std::vector<std::shared_ptr<CsgNode>>>
+      original_;
 
   void SetOp(Manifold::OpType);
+  void ReleaseOriginal() const;
 
-  static void BatchBoolean(
+  static std::shared_ptr<CsgLeafNode> SimpleBoolean(
+      const CsgLeafNode &a, const CsgLeafNode &b, Manifold::OpType operation,
+      std::vector<BooleanStats> &stats);
+
+  static std::shared_ptr<CsgLeafNode> BatchBoolean(
       Manifold::OpType operation,
-      std::vector<std::shared_ptr<const Manifold::Impl>> &results);
+      std::vector<std::shared_ptr<CsgLeafNode>> &results,
+      std::vector<BooleanStats> &stats);
+
+  static std::shared_ptr<CsgLeafNode> BatchUnion(
+      std::vector<std::shared_ptr<CsgLeafNode>> &children,
+      std::vector<BooleanStats> &stats);
 
-  void BatchUnion() const;
+  std::vector<std::shared_ptr<CsgLeafNode>> SetAsideInstances(
+      std::vector<std::shared_ptr<CsgNode>> &children) const;
 
   std::vector<std::shared_ptr<CsgNode>> &GetChildren(
-      bool finalize = true) const;
+      bool finalize = true, std::vector<BooleanStats> *stats = nullptr) const;
 };
 
 }  // namespace manifold
@@ -135,12 +135,14 @@ namespace manifold {
  * removal, by setting vertPos to NaN and halfedge to {-1, -1, -1, -1}.
  */
 void Manifold::Impl::SimplifyTopology() {
+  TraceScope trace("SimplifyTopology");
   auto policy = autoPolicy(halfedge_.size());
 
   VecDH<Halfedge> halfedge(halfedge_);
   VecDH<int> idx(halfedge_.size());
   sequence(policy, idx.begin(), idx.end());
-  sort_by_key(policy, halfedge.begin(), halfedge.end(), idx.begin());
+  sort_by_key(autoPolicy(halfedge.size(), OpKind::Sort), halfedge.begin(),
+              halfedge.end(), idx.begin());
 
   VecDH<int> flaggedEdges(halfedge_.size());
 
@@ -32,6 +32,7 @@ namespace manifold {
 void Manifold::Impl::Face2Tri(const VecDH<int>& faceEdge,
                               const VecDH<BaryRef>& faceRef,
                               const VecDH<int>& halfedgeBary) {
+  TraceScope trace("Face2Tri");
   VecDH<glm::ivec3> triVerts;
   VecDH<glm::vec3> triNormal;
   VecDH<BaryRef>& triBary = meshRelation_.triBary;
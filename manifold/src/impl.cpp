@@ -14,10 +14,12 @@
 
 #include "impl.h"
 
+#include <thrust/iterator/transform_iterator.h>
 #include <thrust/logical.h>
 
 #include <algorithm>
 #include <atomic>
+#include <cstring>
 #include <map>
 
 #include "graph.h"
@@ -106,10 +108,9 @@ struct Tri2Halfedges {
   Halfedge* halfedges;
   TmpEdge* edges;
 
-  __host__ __device__ void operator()(
-      thrust::tuple<int, const glm::ivec3&> in) {
+  __host__ __device__ void operator()(thrust::tuple<int, glm::ivec3> in) {
     const int tri = thrust::get<0>(in);
-    const glm::ivec3& triVerts = thrust::get<1>(in);
+    const glm::ivec3 triVerts = thrust::get<1>(in);
     for (const int i : {0, 1, 2}) {
       const int j = (i + 1) % 3;
       const int edge = 3 * tri + i;
@@ -133,6 +134,72 @@ struct LinkHalfedges {
   }
 };
 
+/**
+ * Pairs up the halfedges of the edges made by Tri2Halfedges.
+ */
+void LinkEdges(VecDH<Halfedge>& halfedge, VecDH<TmpEdge>& edge) {
+  // Stable sort is required here so that halfedges from the same face are
+  // paired together (the triangles were created in face order). In some
+  // degenerate situations the triangulator can add the same internal edge in
+  // two different faces, causing this edge to not be 2-manifold. These are
+  // fixed by duplicating verts in SimplifyTopology.
+  stable_sort(autoPolicy(edge.size(), OpKind::Sort), edge.begin(), edge.end());
+  thrust::for_each_n(thrust::host, countAt(0), halfedge.size() / 2,
+                     LinkHalfedges({halfedge.ptrH(), edge.cptrH()}));
+}
+
+struct ReadVertPos {
+  const char* vertPos;
+  const int stride;
+  const bool isDouble;
+
+  // The caller's buffer need not be aligned, so the values are copied out.
+  __host__ __device__ glm::vec3 operator()(int vert) const {
+    const char* ptr = vertPos + static_cast<size_t>(vert) * stride;
+    if (isDouble) {
+      glm::dvec3 pos;
+      memcpy(&pos, ptr, sizeof(pos));
+      return glm::vec3(pos);
+    }
+    glm::vec3 pos;
+    memcpy(&pos, ptr, sizeof(pos));
+    return pos;
+  }
+};
+
+struct ReadTriVerts {
+  const char* triVerts;
+  const int stride;
+  const int indexBytes;
+
+  __host__ __device__ glm::ivec3 operator()(int tri) const {
+    const char* ptr = triVerts + static_cast<size_t>(tri) * stride;
+    glm::ivec3 verts;
+    for (const int i : {0, 1, 2}) {
+      if (indexBytes == 2) {
+        uint16_t index;
+        memcpy(&index, ptr + 2 * i, 2);
+        verts[i] = index;
+      } else {
+        uint32_t index;
+        memcpy(&index, ptr + 4 * i, 4);
+        verts[i] = index;
+      }
+    }
+    return verts;
+  }
+};
+
+struct IndexInRange {
+  const int numVert;
+
+  __host__ __device__ bool operator()(glm::ivec3 tri) const {
+    bool good = true;
+    for (const int i : {0, 1, 2}) good &= tri[i] >= 0 && tri[i] < numVert;
+    return good;
+  }
+};
+
 struct InitializeBaryRef {
   const int meshID;
   const Halfedge* halfedge;
@@ -272,6 +339,38 @@ Manifold::Impl::Impl(const Mesh& mesh,
   Finish();
 }
 
+/**
+ * Create a manifold from a mesh in caller-owned buffers, reading them in
+ * parallel without an intermediate Mesh. Will throw if it is not manifold.
+ * Its precision is at least minPrecision, which applies to its simplification.
+ */
+Manifold::Impl::Impl(const MeshView& view, float minPrecision) {
+  ALWAYS_ASSERT(view.indexBytes == 2 || view.indexBytes == 4, userErr,
+                "Indices must be 2 or 4 bytes.");
+  ALWAYS_ASSERT(view.numVert == 0 || view.vertPos != nullptr, userErr,
+                "Missing vertex positions.");
+  ALWAYS_ASSERT(view.numTri == 0 || view.triVerts != nullptr, userErr,
+                "Missing triangle indices.");
+  CheckDevice();
+  const int stride = view.vertStride > 0
+                         ? view.vertStride
+                         : 3 * (view.doublePositions ? sizeof(double)
+                                                     : sizeof(float));
+  vertPos_.resize(view.numVert);
+  transform(HostPolicy(view.numVert), countAt(0), countAt(view.numVert),
+            vertPos_.ptrH(),
+            ReadVertPos({static_cast<const char*>(view.vertPos), stride,
+                         view.doublePositions}));
+  CalculateBBox();
+  SetPrecision(minPrecision);
+  CreateHalfedges(view);
+  ALWAYS_ASSERT(IsManifold(), topologyErr, "Input mesh is not manifold!");
+  CalculateNormals();
+  InitializeNewReference();
+  SimplifyTopology();
+  Finish();
+}
+
 /**
  * Create eiter a unit tetrahedron, cube or octahedron. The cube is in the first
  * octant, while the others are symmetric about the origin.
@@ -453,14 +552,28 @@ void Manifold::Impl::CreateHalfedges(const VecDH<glm::ivec3>& triVerts) {
   auto policy = autoPolicy(numTri);
   for_each_n(policy, zip(countAt(0), triVerts.begin()), numTri,
              Tri2Halfedges({halfedge_.ptrD(), edge.ptrD()}));
-  // Stable sort is required here so that halfedges from the same face are
-  // paired together (the triangles were created in face order). In some
-  // degenerate situations the triangulator can add the same internal edge in
-  // two different faces, causing this edge to not be 2-manifold. These are
-  // fixed by duplicating verts in SimplifyTopology.
-  stable_sort(policy, edge.begin(), edge.end());
-  thrust::for_each_n(thrust::host, countAt(0), halfedge_.size() / 2,
-                     LinkHalfedges({halfedge_.ptrH(), edge.cptrH()}));
+  LinkEdges(halfedge_, edge);
+}
+
+/**
+ * Create the halfedge_ data structure directly from the caller's index buffer.
+ */
+void Manifold::Impl::CreateHalfedges(const MeshView& view) {
+  const int numTri = view.numTri;
+  halfedge_.resize(0);
+  halfedge_.resize(3 * numTri);
+  VecDH<TmpEdge> edge(3 * numTri);
+  const int stride =
+      view.triStride > 0 ? view.triStride : 3 * view.indexBytes;
+  auto triVerts = thrust::make_transform_iterator(
+      countAt(0), ReadTriVerts({static_cast<const char*>(view.triVerts),
+                                stride, view.indexBytes}));
+  ALWAYS_ASSERT(all_of(HostPolicy(numTri), triVerts, triVerts + numTri,
+                       IndexInRange({NumVert()})),
+                userErr, "Vertex index out of range.");
+  for_each_n(HostPolicy(numTri), zip(countAt(0), triVerts), numTri,
+             Tri2Halfedges({halfedge_.ptrH(), edge.ptrH()}));
+  LinkEdges(halfedge_, edge);
 }
 
 /**
@@ -568,7 +681,7 @@ void Manifold::Impl::CalculateNormals() {
 void Manifold::Impl::UpdateMeshIDs(VecDH<int>& meshIDs, VecDH<int>& originalIDs,
                                    int startTri, int n, int startID) {
   if (n == -1) n = meshRelation_.triBary.size();
-  sort_by_key(autoPolicy(n), meshIDs.begin(), meshIDs.end(),
+  sort_by_key(autoPolicy(n, OpKind::Sort), meshIDs.begin(), meshIDs.end(),
               originalIDs.begin());
   constexpr int kOccurred = 1 << 30;
   VecDH<int> error(1, -1);
@@ -59,6 +59,7 @@ struct Manifold::Impl {
        const std::vector<glm::ivec3>& triProperties = std::vector<glm::ivec3>(),
        const std::vector<float>& properties = std::vector<float>(),
        const std::vector<float>& propertyTolerance = std::vector<float>());
+  Impl(const MeshView&, float minPrecision = -1);
 
   int InitializeNewReference(
       const std::vector<glm::ivec3>& triProperties = std::vector<glm::ivec3>(),
@@ -67,6 +68,7 @@ struct Manifold::Impl {
 
   void ReinitializeReference(int meshID);
   void CreateHalfedges(const VecDH<glm::ivec3>& triVerts);
+  void CreateHalfedges(const MeshView& view);
   void CalculateNormals();
   void UpdateMeshIDs(VecDH<int>& meshIDs, VecDH<int>& originalIDs,
                      int startTri = 0, int n = -1, int startID = 0);
@@ -88,11 +90,16 @@ struct Manifold::Impl {
   bool IsManifold() const;
   bool MatchesTriNormals() const;
   int NumDegenerateTris() const;
+  SparseIndices SelfIntersections() const;
+  bool SurfacesIntersect(const Impl& Q) const;
 
   // sort.cu
   void Finish();
+  bool FinishComposed(const std::vector<const Collider*>& colliders);
   void SortVerts();
   void ReindexVerts(const VecDH<int>& vertNew2Old, int numOldVert);
+  void WeldVerts(VecDH<glm::ivec3>& triVerts, float tolerance);
+  void ReorderForRendering(VecDH<glm::ivec3>& triVerts);
   void GetFaceBoxMorton(VecDH<Box>& faceBox, VecDH<uint32_t>& faceMorton) const;
   void SortFaces(VecDH<Box>& faceBox, VecDH<uint32_t>& faceMorton);
   void GatherFaces(const VecDH<int>& faceNew2Old);
@@ -12,6 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <cstring>
+
 #include "boolean3.h"
 #include "csg_tree.h"
 #include "impl.h"
@@ -34,12 +37,84 @@ struct MakeTri {
   }
 };
 
+struct WriteFloats {
+  char* out;
+  const int stride;
+  const float* in;
+  const int width;
+
+  // The caller's buffer need not be aligned, so the values are copied in.
+  __host__ __device__ void operator()(int i) {
+    memcpy(out + static_cast<size_t>(i) * stride, in + width * i,
+           width * sizeof(float));
+  }
+};
+
+struct WriteTri {
+  char* out;
+  const int stride;
+  const int indexBytes;
+  const Halfedge* halfedges;
+  const int firstTri;
+
+  __host__ __device__ void operator()(int index) {
+    char* dst = out + static_cast<size_t>(index) * stride;
+    const int tri = firstTri + index;
+    for (int i : {0, 1, 2}) {
+      const int vert = halfedges[3 * tri + i].startVert;
+      if (indexBytes == 2) {
+        const uint16_t index = vert;
+        memcpy(dst + 2 * i, &index, 2);
+      } else {
+        const uint32_t index = vert;
+        memcpy(dst + 4 * i, &index, 4);
+      }
+    }
+  }
+};
+
+void WriteVec(void* out, int stride, const float* in, int width, int n) {
+  if (out == nullptr || n == 0) return;
+  for_each_n(HostPolicy(n), countAt(0), n,
+             WriteFloats({static_cast<char*>(out),
+                          stride > 0 ? stride
+                                     : width * static_cast<int>(sizeof(float)),
+                          in, width}));
+}
+
 struct GetMeshID {
   __host__ __device__ void operator()(thrust::tuple<int&, BaryRef> inOut) {
     thrust::get<0>(inOut) = thrust::get<1>(inOut).meshID;
   }
 };
 
+struct CheckInterference {
+  const std::shared_ptr<const Manifold::Impl>* impls;
+  Interference* pairs;
+  char* interferes;
+  const bool calculateVolume;
+
+  void operator()(int i) {
+    Interference& pair = pairs[i];
+    const Manifold::Impl& implA = *impls[pair.first];
+    const Manifold::Impl& implB = *impls[pair.second];
+
+    const bool surfaces = implA.SurfacesIntersect(implB);
+    // Parts with disjoint surfaces still interfere if one encloses the other.
+    const bool nested = !surfaces && (implA.bBox_.Contains(implB.bBox_) ||
+                                      implB.bBox_.Contains(implA.bBox_));
+    float volume = NAN;
+    if (nested || (surfaces && calculateVolume)) {
+      Boolean3 boolean(implA, implB, Manifold::OpType::INTERSECT);
+      volume = boolean.Result(Manifold::OpType::INTERSECT)
+                   .GetProperties()
+                   .volume;
+    }
+    interferes[i] = surfaces || (nested && volume > 0);
+    pair.volume = calculateVolume ? volume : NAN;
+  }
+};
+
 Manifold Halfspace(Box bBox, glm::vec3 normal, float originOffset) {
   normal = glm::normalize(normal);
   Manifold cutter =
@@ -64,7 +139,8 @@ Manifold::~Manifold() = default;
 Manifold::Manifold(Manifold&&) noexcept = default;
 Manifold& Manifold::operator=(Manifold&&) noexcept = default;
 
-Manifold::Manifold(const Manifold& other) : pNode_(other.pNode_) {}
+Manifold::Manifold(const Manifold& other)
+    : pNode_(std::atomic_load(&other.pNode_)) {}
 
 Manifold::Manifold(std::shared_ptr<CsgNode> pNode) : pNode_(pNode) {}
 
@@ -73,16 +149,24 @@ Manifold::Manifold(std::shared_ptr<Impl> pImpl_)
 
 Manifold& Manifold::operator=(const Manifold& other) {
   if (this != &other) {
-    pNode_ = other.pNode_;
+    pNode_ = std::atomic_load(&other.pNode_);
   }
   return *this;
 }
 
+/**
+ * Evaluates the CSG tree, which may happen from several threads at once for a
+ * shared Manifold. ToLeafNode() hands every caller the same cached leaf, so
+ * racing stores to pNode_ all write the same pointer and the returned
+ * reference stays valid.
+ */
 CsgLeafNode& Manifold::GetCsgLeafNode() const {
-  if (pNode_->GetNodeType() != CsgNodeType::LEAF) {
-    pNode_ = pNode_->ToLeafNode();
+  std::shared_ptr<CsgNode> node = std::atomic_load(&pNode_);
+  if (node->GetNodeType() != CsgNodeType::LEAF) {
+    node = node->ToLeafNode();
+    std::atomic_store(&pNode_, node);
   }
-  return *std::static_pointer_cast<CsgLeafNode>(pNode_);
+  return *std::static_pointer_cast<CsgLeafNode>(node);
 }
 
 /**
@@ -118,6 +202,18 @@ Manifold::Manifold(const Mesh& mesh,
     : pNode_(std::make_shared<CsgLeafNode>(std::make_shared<Impl>(
           mesh, triProperties, properties, propertyTolerance))) {}
 
+/**
+ * Convert a mesh held in the caller's own buffers into a Manifold. The
+ * positions and indices are read directly, in parallel, so they are only
+ * copied once, into the Manifold's own storage. The buffers may be freed once
+ * this returns. Will throw a topologyErr exception if the input is not an
+ * oriented 2-manifold.
+ *
+ * @param view The buffers and their layouts; see MeshView.
+ */
+Manifold::Manifold(const MeshView& view)
+    : pNode_(std::make_shared<CsgLeafNode>(std::make_shared<Impl>(view))) {}
+
 /**
  * This returns a Mesh of simple vectors of vertices and triangles suitable for
  * saving or other operations outside of the context of this library.
@@ -142,14 +238,59 @@ Mesh Manifold::GetMesh() const {
   return result;
 }
 
-int Manifold::circularSegments_ = 0;
-float Manifold::circularAngle_ = 10.0f;
-float Manifold::circularEdgeLength_ = 1.0f;
+/**
+ * Writes the mesh into the caller's buffers in parallel, in the same order as
+ * GetMesh(), but without allocating. Suited to extracting a mesh every frame,
+ * e.g. straight into a mapped vertex buffer.
+ *
+ * @param buffers Where and in which layout to write each attribute, and
+ * optionally which range of vertices and triangles; see MeshBuffers.
+ */
+void Manifold::GetMesh(const MeshBuffers& buffers) const {
+  ALWAYS_ASSERT(buffers.indexBytes == 2 || buffers.indexBytes == 4, userErr,
+                "Indices must be 2 or 4 bytes.");
+  const Impl& impl = *GetCsgLeafNode().GetImpl();
+  ALWAYS_ASSERT(buffers.indexBytes == 4 || impl.NumVert() <= 65536, userErr,
+                "Too many vertices for 16-bit indices.");
+  const int firstVert = buffers.firstVert;
+  const int numVert =
+      buffers.numVert < 0 ? impl.NumVert() - firstVert : buffers.numVert;
+  ALWAYS_ASSERT(firstVert >= 0 && numVert >= 0 &&
+                    firstVert + numVert <= impl.NumVert(),
+                userErr, "Vertex range is out of bounds.");
+  const int firstTri = buffers.firstTri;
+  const int numTri =
+      buffers.numTri < 0 ? impl.NumTri() - firstTri : buffers.numTri;
+  ALWAYS_ASSERT(
+      firstTri >= 0 && numTri >= 0 && firstTri + numTri <= impl.NumTri(),
+      userErr, "Triangle range is out of bounds.");
+
+  WriteVec(buffers.vertPos, buffers.vertStride,
+           reinterpret_cast<const float*>(impl.vertPos_.cptrH() + firstVert),
+           3, numVert);
+  if (impl.vertNormal_.size() > 0)
+    WriteVec(
+        buffers.vertNormal, buffers.normalStride,
+        reinterpret_cast<const float*>(impl.vertNormal_.cptrH() + firstVert),
+        3, numVert);
+  if (impl.halfedgeTangent_.size() > 0)
+    WriteVec(buffers.halfedgeTangent, buffers.tangentStride,
+             reinterpret_cast<const float*>(impl.halfedgeTangent_.cptrH() +
+                                            3 * firstTri),
+             4, 3 * numTri);
+  if (buffers.triVerts == nullptr || numTri == 0) return;
+  const int stride =
+      buffers.triStride > 0 ? buffers.triStride : 3 * buffers.indexBytes;
+  for_each_n(HostPolicy(numTri), countAt(0), numTri,
+             WriteTri({static_cast<char*>(buffers.triVerts), stride,
+                       buffers.indexBytes, impl.halfedge_.cptrH(), firstTri}));
+}
 
 /**
  * Sets an angle constraint the default number of circular segments for the
  * Cylinder(), Sphere(), and Revolve() constructors. The number of segments will
- * be rounded up to the nearest factor of four.
+ * be rounded up to the nearest factor of four. Like the other circular
+ * settings, this belongs to the current ExecutionContext.
  *
  * @param angle The minimum angle in degrees between consecutive segments. The
  * angle will increase if the the segments hit the minimum edge length. Default
@@ -157,7 +298,7 @@ float Manifold::circularEdgeLength_ = 1.0f;
  */
 void Manifold::SetMinCircularAngle(float angle) {
   ALWAYS_ASSERT(angle > 0.0f, userErr, "angle must be positive!");
-  Manifold::circularAngle_ = angle;
+  CurrentContext().circularAngle = angle;
 }
 
 /**
@@ -170,7 +311,7 @@ void Manifold::SetMinCircularAngle(float angle) {
  */
 void Manifold::SetMinCircularEdgeLength(float length) {
   ALWAYS_ASSERT(length > 0.0f, userErr, "length must be positive!");
-  Manifold::circularEdgeLength_ = length;
+  CurrentContext().circularEdgeLength = length;
 }
 
 /**
@@ -184,7 +325,7 @@ void Manifold::SetMinCircularEdgeLength(float length) {
 void Manifold::SetCircularSegments(int number) {
   ALWAYS_ASSERT(number > 2 || number == 0, userErr,
                 "must have at least three segments in circle!");
-  Manifold::circularSegments_ = number;
+  CurrentContext().circularSegments = number;
 }
 
 /**
@@ -195,9 +336,10 @@ void Manifold::SetCircularSegments(int number) {
  * segments there will be.
  */
 int Manifold::GetCircularSegments(float radius) {
-  if (Manifold::circularSegments_ > 0) return Manifold::circularSegments_;
-  int nSegA = 360.0f / Manifold::circularAngle_;
-  int nSegL = 2.0f * radius * glm::pi<float>() / Manifold::circularEdgeLength_;
+  const ExecutionContext& context = CurrentContext();
+  if (context.circularSegments > 0) return context.circularSegments;
+  int nSegA = 360.0f / context.circularAngle;
+  int nSegL = 2.0f * radius * glm::pi<float>() / context.circularEdgeLength;
   int nSeg = fmin(nSegA, nSegL) + 3;
   nSeg -= nSeg % 4;
   return nSeg;
@@ -236,6 +378,16 @@ float Manifold::Precision() const {
   return GetCsgLeafNode().GetImpl()->precision_;
 }
 
+/**
+ * Returns the statistics of the Boolean operations evaluated to produce this
+ * Manifold, in the order they ran. Results that were already evaluated when
+ * they became operands only contribute their own operations once. To observe
+ * every Boolean as it happens instead, set ExecutionContext::onBoolean.
+ */
+std::vector<BooleanStats> Manifold::GetBooleanStats() const {
+  return GetCsgLeafNode().GetBooleanStats();
+}
+
 /**
  * The genus is a topological property of the manifold, representing the number
  * of "handles". A sphere is 0, torus 1, etc. It is only meaningful for a single
@@ -268,6 +420,33 @@ Curvature Manifold::GetCurvature() const {
   return GetCsgLeafNode().GetImpl()->GetCurvature();
 }
 
+/**
+ * The number of pairs of triangles that cut through each other. This should be
+ * zero for any valid manifold, so it is a quick way to check an imported mesh
+ * before using it in Boolean operations. Triangles that share an edge are not
+ * tested, and those that only touch, such as at a shared vertex, within
+ * Precision() do not count.
+ */
+int Manifold::NumSelfIntersections() const {
+  return GetCsgLeafNode().GetImpl()->SelfIntersections().size();
+}
+
+/**
+ * The pairs of triangles counted by NumSelfIntersections(), as indices into
+ * GetMesh().triVerts, with first < second.
+ */
+std::vector<std::pair<int, int>> Manifold::SelfIntersectingPairs() const {
+  const SparseIndices tri2tri =
+      GetCsgLeafNode().GetImpl()->SelfIntersections();
+  const VecDH<int>& triP = tri2tri.Get(0);
+  const VecDH<int>& triQ = tri2tri.Get(1);
+  std::vector<std::pair<int, int>> out(tri2tri.size());
+  for (int i = 0; i < tri2tri.size(); ++i) {
+    out[i] = std::make_pair(triP[i], triQ[i]);
+  }
+  return out;
+}
+
 /**
  * Gets the relationship to the previous mesh, for the purpose of assinging
  * properties like texture coordinates. The triBary vector is the same length as
@@ -326,6 +505,87 @@ Manifold Manifold::AsOriginal() const {
   return Manifold(std::make_shared<CsgLeafNode>(newImpl));
 }
 
+/**
+ * Starts evaluating the pending Boolean operations of this Manifold on a
+ * background thread, instead of on the first query. The returned handle
+ * reports progress and can cancel the work, which stops between the phases of
+ * a Boolean and frees its temporary memory. Finished sub-operations stay
+ * cached, so evaluating again after a cancellation resumes from there.
+ *
+ * @param context The settings to evaluate with. Its progress is replaced by
+ * the one of the returned handle.
+ */
+ManifoldFuture Manifold::EvaluateAsync(const ExecutionContext& context) const {
+  auto progress = std::make_shared<Progress>();
+  progress->AddSteps(3 * std::atomic_load(&pNode_)->NumPendingBooleans());
+  ExecutionContext asyncContext = context;
+  asyncContext.progress = progress;
+  const Manifold manifold(*this);
+  std::future<Manifold> future =
+      std::async(std::launch::async, [asyncContext, manifold]() {
+        asyncContext.Execute([&manifold]() { manifold.GetCsgLeafNode(); });
+        asyncContext.progress->Finish();
+        return manifold;
+      });
+  return ManifoldFuture(std::move(future), progress);
+}
+
+ManifoldFuture::ManifoldFuture(std::future<Manifold>&& future,
+                               std::shared_ptr<Progress> progress)
+    : future_(std::move(future)), progress_(progress) {}
+
+ManifoldFuture::~ManifoldFuture() {
+  if (progress_ != nullptr && future_.valid()) progress_->Cancel();
+}
+
+/**
+ * Cancels the evaluation this handle had, if any, and waits for it to stop
+ * before taking over the other one.
+ */
+ManifoldFuture& ManifoldFuture::operator=(ManifoldFuture&& other) {
+  if (this == &other) return *this;
+  if (progress_ != nullptr && future_.valid()) progress_->Cancel();
+  future_ = std::move(other.future_);
+  progress_ = std::move(other.progress_);
+  return *this;
+}
+
+/**
+ * Is the evaluation done, either with a result or an exception?
+ */
+bool ManifoldFuture::Ready() const { return WaitFor(0); }
+
+/**
+ * Waits up to the given time for the evaluation to be done and returns
+ * whether it is.
+ */
+bool ManifoldFuture::WaitFor(float seconds) const {
+  return future_.wait_for(std::chrono::duration<float>(seconds)) ==
+         std::future_status::ready;
+}
+
+/**
+ * The fraction of the evaluation that is done, from 0 to 1, or 0 if this
+ * handle was moved from.
+ */
+float ManifoldFuture::GetProgress() const {
+  return progress_ == nullptr ? 0.0f : progress_->Fraction();
+}
+
+/**
+ * Asks the evaluation to stop at its next checkpoint, after which Get() throws
+ * canceledErr. This does not wait for it to stop.
+ */
+void ManifoldFuture::Cancel() {
+  if (progress_ != nullptr) progress_->Cancel();
+}
+
+/**
+ * Waits for the evaluation and returns the evaluated Manifold, or rethrows its
+ * exception. This can only be called once.
+ */
+Manifold ManifoldFuture::Get() { return future_.get(); }
+
 /**
  * Should always be true. Also checks saneness of the internal data structures.
  */
@@ -374,7 +634,7 @@ int Manifold::NumOverlaps(const Manifold& other) const {
  * @param v The vector to add to every vertex.
  */
 Manifold Manifold::Translate(glm::vec3 v) const {
-  return Manifold(pNode_->Translate(v));
+  return Manifold(std::atomic_load(&pNode_)->Translate(v));
 }
 
 /**
@@ -384,7 +644,7 @@ Manifold Manifold::Translate(glm::vec3 v) const {
  * @param v The vector to multiply every vertex by per component.
  */
 Manifold Manifold::Scale(glm::vec3 v) const {
-  return Manifold(pNode_->Scale(v));
+  return Manifold(std::atomic_load(&pNode_)->Scale(v));
 }
 
 /**
@@ -401,7 +661,8 @@ Manifold Manifold::Scale(glm::vec3 v) const {
  */
 Manifold Manifold::Rotate(float xDegrees, float yDegrees,
                           float zDegrees) const {
-  return Manifold(pNode_->Rotate(xDegrees, yDegrees, zDegrees));
+  return Manifold(
+      std::atomic_load(&pNode_)->Rotate(xDegrees, yDegrees, zDegrees));
 }
 
 /**
@@ -412,7 +673,7 @@ Manifold Manifold::Rotate(float xDegrees, float yDegrees,
  * @param m The affine transform matrix to apply to all the vertices.
  */
 Manifold Manifold::Transform(const glm::mat4x3& m) const {
-  return Manifold(pNode_->Transform(m));
+  return Manifold(std::atomic_load(&pNode_)->Transform(m));
 }
 
 /**
@@ -466,10 +727,32 @@ Manifold Manifold::Refine(int n) const {
  * @param op The type of operation to perform.
  */
 Manifold Manifold::Boolean(const Manifold& second, OpType op) const {
-  std::vector<std::shared_ptr<CsgNode>> children({pNode_, second.pNode_});
+  std::vector<std::shared_ptr<CsgNode>> children(
+      {std::atomic_load(&pNode_), std::atomic_load(&second.pNode_)});
   return Manifold(std::make_shared<CsgOpNode>(children, op));
 }
 
+/**
+ * Combines a whole list of manifolds with one operation, evaluated as a
+ * single batch: operands are combined smallest first, and a union composes
+ * the ones whose bounding boxes do not overlap instead of intersecting them.
+ * This is much faster than folding the list with Boolean() one at a time.
+ *
+ * @param manifolds The operands. For SUBTRACT, all the others are subtracted
+ * from the first.
+ * @param op The type of operation to perform.
+ */
+Manifold Manifold::BatchBoolean(const std::vector<Manifold>& manifolds,
+                                OpType op) {
+  if (manifolds.empty()) return Manifold();
+  if (manifolds.size() == 1) return manifolds[0];
+  std::vector<std::shared_ptr<CsgNode>> children;
+  children.reserve(manifolds.size());
+  for (const Manifold& manifold : manifolds)
+    children.push_back(std::atomic_load(&manifold.pNode_));
+  return Manifold(std::make_shared<CsgOpNode>(std::move(children), op));
+}
+
 /**
  * Shorthand for Boolean Union.
  */
@@ -523,14 +806,19 @@ Manifold& Manifold::operator^=(const Manifold& Q) {
  * @param cutter
  */
 std::pair<Manifold, Manifold> Manifold::Split(const Manifold& cutter) const {
-  auto impl1 = GetCsgLeafNode().GetImpl();
-  auto impl2 = cutter.GetCsgLeafNode().GetImpl();
+  const CsgLeafNode& leaf1 = GetCsgLeafNode();
+  const CsgLeafNode& leaf2 = cutter.GetCsgLeafNode();
+  auto impl1 = leaf1.GetBaseImpl();
+  auto impl2 = leaf2.GetBaseImpl();
 
-  Boolean3 boolean(*impl1, *impl2, OpType::SUBTRACT);
+  Boolean3 boolean(*impl1, leaf1.GetTransform(), *impl2, leaf2.GetTransform(),
+                   OpType::SUBTRACT);
   auto result1 = std::make_shared<CsgLeafNode>(
-      std::make_unique<Impl>(boolean.Result(OpType::INTERSECT)));
+      std::make_unique<Impl>(boolean.Result(OpType::INTERSECT)),
+      boolean.Frame());
   auto result2 = std::make_shared<CsgLeafNode>(
-      std::make_unique<Impl>(boolean.Result(OpType::SUBTRACT)));
+      std::make_unique<Impl>(boolean.Result(OpType::SUBTRACT)),
+      boolean.Frame());
   return std::make_pair(Manifold(result1), Manifold(result2));
 }
 
@@ -561,4 +849,128 @@ Manifold Manifold::TrimByPlane(glm::vec3 normal, float originOffset) const {
   return *this ^ Halfspace(BoundingBox(), normal, originOffset);
 }
 
+/**
+ * Finds every pair of the given manifolds that interfere, meaning their
+ * surfaces intersect or one encloses the other; touching within Precision()
+ * does not count. Candidate pairs come from a collider built over the bounding
+ * boxes of the parts, and are then checked triangle-by-triangle in parallel,
+ * so this is much faster than testing every pair with a Boolean.
+ *
+ * @param manifolds The parts to check, each in its own placement.
+ * @param calculateVolume If true, also compute the volume of each
+ * intersection, which costs a Boolean per interfering pair. Otherwise
+ * Interference.volume is NaN.
+ * @return The interfering pairs, sorted by first and then second.
+ */
+std::vector<Interference> Manifold::Interferences(
+    const std::vector<Manifold>& manifolds, bool calculateVolume) {
+  std::vector<Interference> out;
+  const int numPart = manifolds.size();
+  if (numPart < 2) return out;
+
+  // GetImpl() may apply a pending transform, so this is done serially.
+  std::vector<std::shared_ptr<const Impl>> impls;
+  impls.reserve(numPart);
+  Box sceneBox;
+  for (const Manifold& manifold : manifolds) {
+    impls.push_back(manifold.GetCsgLeafNode().GetImpl());
+    sceneBox = sceneBox.Union(impls.back()->bBox_);
+  }
+
+  VecDH<Box> partBox(numPart);
+  VecDH<uint32_t> partMorton(numPart);
+  VecDH<int> partNew2Old(numPart);
+  for (int i = 0; i < numPart; ++i) {
+    partBox[i] = impls[i]->bBox_;
+    partMorton[i] = MortonCode(partBox[i].Center(), sceneBox);
+    partNew2Old[i] = i;
+  }
+  sort_by_key(autoPolicy(numPart, OpKind::Sort), partMorton.begin(),
+              partMorton.end(), zip(partBox.begin(), partNew2Old.begin()));
+
+  const Collider collider(partBox, partMorton);
+  const SparseIndices part2part = collider.Collisions(partBox);
+  const VecDH<int>& partP = part2part.Get(0);
+  const VecDH<int>& partQ = part2part.Get(1);
+  std::vector<Interference> candidates;
+  for (int i = 0; i < part2part.size(); ++i) {
+    if (partP[i] >= partQ[i]) continue;
+    const int a = partNew2Old[partP[i]];
+    const int b = partNew2Old[partQ[i]];
+    candidates.push_back({glm::min(a, b), glm::max(a, b), NAN});
+  }
+  std::sort(candidates.begin(), candidates.end(),
+            [](const Interference& a, const Interference& b) {
+              return a.first == b.first ? a.second < b.second
+                                        : a.first < b.first;
+            });
+
+  std::vector<char> interferes(candidates.size());
+  // Each candidate is a whole Boolean, so this is worth spreading over threads
+  // regardless of how few there are.
+  for_each_n(ExecutionPolicy::Par, countAt(0), candidates.size(),
+             CheckInterference({impls.data(), candidates.data(),
+                                interferes.data(), calculateVolume}));
+  for (int i = 0; i < candidates.size(); ++i) {
+    if (interferes[i]) out.push_back(candidates[i]);
+  }
+  return out;
+}
+
+/**
+ * Turns a triangle soup, such as an STL, into indexed triangles ready for
+ * Manifold(const Mesh&) by merging vertices that are within tolerance of each
+ * other, in parallel. Triangles collapsed by the merge are removed; vertNormal
+ * and halfedgeTangent are not carried over.
+ *
+ * @param soup The triangles, which may each have their own vertices.
+ * @param tolerance Vertices up to this distance apart are merged, as are
+ * chains of such vertices. Zero merges only identical positions.
+ */
+Mesh WeldVertices(const Mesh& soup, float tolerance) {
+  TraceScope trace("WeldVertices");
+  Manifold::Impl impl;
+  impl.vertPos_ = soup.vertPos;
+  VecDH<glm::ivec3> triVerts(soup.triVerts);
+  impl.WeldVerts(triVerts, tolerance);
+
+  Mesh result;
+  result.vertPos.insert(result.vertPos.end(), impl.vertPos_.cbegin(),
+                        impl.vertPos_.cend());
+  result.triVerts.insert(result.triVerts.end(), triVerts.cbegin(),
+                         triVerts.cend());
+  return result;
+}
+
+/**
+ * Returns a copy of the mesh reordered for rendering: triangles are ordered
+ * for the GPU's post-transform vertex cache (Tipsify) and then vertices by
+ * first use, for locality of vertex fetch. Vertex normals and halfedge
+ * tangents follow their vertices and triangles. Triangles are reordered within
+ * clusters of consecutive ones in parallel, which suits the spatially sorted
+ * output of GetMesh().
+ *
+ * @param mesh The mesh to reorder, usually from Manifold::GetMesh().
+ */
+Mesh ReorderForRendering(const Mesh& mesh) {
+  TraceScope trace("ReorderForRendering");
+  Manifold::Impl impl;
+  impl.vertPos_ = mesh.vertPos;
+  impl.vertNormal_ = mesh.vertNormal;
+  impl.halfedgeTangent_ = mesh.halfedgeTangent;
+  VecDH<glm::ivec3> triVerts(mesh.triVerts);
+  impl.ReorderForRendering(triVerts);
+
+  Mesh result;
+  result.vertPos.insert(result.vertPos.end(), impl.vertPos_.cbegin(),
+                        impl.vertPos_.cend());
+  result.vertNormal.insert(result.vertNormal.end(), impl.vertNormal_.cbegin(),
+                           impl.vertNormal_.cend());
+  result.halfedgeTangent.insert(result.halfedgeTangent.end(),
+                                impl.halfedgeTangent_.cbegin(),
+                                impl.halfedgeTangent_.cend());
+  result.triVerts.insert(result.triVerts.end(), triVerts.cbegin(),
+                         triVerts.cend());
+  return result;
+}
 }  // namespace manifold
@@ -206,6 +206,36 @@ struct CheckCCW {
     return check;
   }
 };
+
+struct TriIntersect {
+  const Halfedge* halfedgeP;
+  const glm::vec3* vertPosP;
+  const Halfedge* halfedgeQ;
+  const glm::vec3* vertPosQ;
+  const float precision;
+  const bool self;
+
+  __host__ __device__ void operator()(thrust::tuple<int&, int, int> inOut) {
+    int& intersects = thrust::get<0>(inOut);
+    const int faceP = thrust::get<1>(inOut);
+    const int faceQ = thrust::get<2>(inOut);
+
+    intersects = 0;
+    if (self && faceP >= faceQ) return;
+
+    glm::vec3 triP[3];
+    glm::vec3 triQ[3];
+    for (int i : {0, 1, 2}) {
+      // Triangles sharing an edge meet along it by construction, so skip them.
+      // Those sharing only a vertex are still tested: they touch at a point,
+      // which the separating axes allow, unless they fold through each other.
+      if (self && halfedgeP[3 * faceP + i].pairedHalfedge / 3 == faceQ) return;
+      triP[i] = vertPosP[halfedgeP[3 * faceP + i].startVert];
+      triQ[i] = vertPosQ[halfedgeQ[3 * faceQ + i].startVert];
+    }
+    intersects = TrianglesIntersect(triP, triQ, precision);
+  }
+};
 }  // namespace
 
 namespace manifold {
@@ -222,7 +252,8 @@ bool Manifold::Impl::IsManifold() const {
   // std::cout << (isManifold ? "" : "Not ") << "Manifold" << std::endl;
 
   VecDH<Halfedge> halfedge(halfedge_);
-  sort(policy, halfedge.begin(), halfedge.end());
+  sort(autoPolicy(halfedge.size(), OpKind::Sort), halfedge.begin(),
+       halfedge.end());
   bool noDupes = all_of(policy, countAt(0), countAt(2 * NumEdge() - 1),
                         NoDuplicates({halfedge.cptrD()}));
   // std::cout << (noDupes ? "" : "Not ") << "2-Manifold" << std::endl;
@@ -249,10 +280,57 @@ int Manifold::Impl::NumDegenerateTris() const {
                             faceNormal_.cptrD(), -1 * precision_ / 2}));
 }
 
+/**
+ * Returns the pairs of triangles (p < q) that intersect each other, found by
+ * querying the face collider with its own boxes. Triangles sharing an edge
+ * are skipped, as are those that only touch within precision_.
+ */
+SparseIndices Manifold::Impl::SelfIntersections() const {
+  if (IsEmpty()) return SparseIndices();
+  VecDH<Box> faceBox;
+  VecDH<uint32_t> faceMorton;
+  GetFaceBoxMorton(faceBox, faceMorton);
+  SparseIndices tri2tri = collider_.Collisions(faceBox);
+
+  VecDH<int> intersects(tri2tri.size());
+  for_each_n(autoPolicy(tri2tri.size()),
+             zip(intersects.begin(), tri2tri.begin(0), tri2tri.begin(1)),
+             tri2tri.size(),
+             TriIntersect({halfedge_.cptrD(), vertPos_.cptrD(),
+                           halfedge_.cptrD(), vertPos_.cptrD(),
+                           glm::max(precision_, 0.0f), true}));
+  tri2tri.RemoveZeros(intersects);
+  tri2tri.Sort();
+  return tri2tri;
+}
+
+/**
+ * Returns true if any triangle of this manifold intersects any triangle of Q,
+ * which must already be in the same coordinate frame. Surfaces that only touch
+ * within precision do not count, nor does one part enclosing the other.
+ */
+bool Manifold::Impl::SurfacesIntersect(const Impl& Q) const {
+  if (IsEmpty() || Q.IsEmpty() || !bBox_.DoesOverlap(Q.bBox_)) return false;
+  VecDH<Box> faceBox;
+  VecDH<uint32_t> faceMorton;
+  GetFaceBoxMorton(faceBox, faceMorton);
+  SparseIndices tri2tri = Q.collider_.Collisions(faceBox);
+
+  VecDH<int> intersects(tri2tri.size());
+  for_each_n(autoPolicy(tri2tri.size()),
+             zip(intersects.begin(), tri2tri.begin(0), tri2tri.begin(1)),
+             tri2tri.size(),
+             TriIntersect({halfedge_.cptrD(), vertPos_.cptrD(),
+                           Q.halfedge_.cptrD(), Q.vertPos_.cptrD(),
+                           glm::max(glm::max(precision_, Q.precision_), 0.0f),
+                           false}));
+  return tri2tri.RemoveZeros(intersects) > 0;
+}
+
 Properties Manifold::Impl::GetProperties() const {
   if (IsEmpty()) return {0, 0};
   auto areaVolume = transform_reduce<thrust::pair<float, float>>(
-      autoPolicy(NumTri()), countAt(0), countAt(NumTri()),
+      autoPolicy(NumTri(), OpKind::Reduce), countAt(0), countAt(NumTri()),
       FaceAreaVolume({halfedge_.cptrD(), vertPos_.cptrD(), precision_}),
       thrust::make_pair(0.0f, 0.0f), SumPair());
   return {areaVolume.first, areaVolume.second};
@@ -275,6 +353,7 @@ Curvature Manifold::Impl::GetCurvature() const {
              zip(vertMeanCurvature.begin(), vertGaussianCurvature.begin(),
                  vertArea.begin(), degree.begin()),
              NumVert(), NormalizeCurvature());
+  policy = autoPolicy(NumVert(), OpKind::Reduce);
   result.minMeanCurvature = reduce<float>(
       policy, vertMeanCurvature.begin(), vertMeanCurvature.end(),
       std::numeric_limits<float>::infinity(), thrust::minimum<float>());
@@ -302,12 +381,12 @@ Curvature Manifold::Impl::GetCurvature() const {
  * range for Morton code calculation.
  */
 void Manifold::Impl::CalculateBBox() {
-  auto policy = autoPolicy(NumVert());
+  auto policy = autoPolicy(NumVert(), OpKind::Reduce);
   bBox_.min = reduce<glm::vec3>(
-      policy, vertPos_.begin(), vertPos_.end(),
+      policy, vertPos_.cbegin(), vertPos_.cend(),
       glm::vec3(std::numeric_limits<float>::infinity()), PosMin());
   bBox_.max = reduce<glm::vec3>(
-      policy, vertPos_.begin(), vertPos_.end(),
+      policy, vertPos_.cbegin(), vertPos_.cend(),
       glm::vec3(-std::numeric_limits<float>::infinity()), PosMax());
 }
 }  // namespace manifold
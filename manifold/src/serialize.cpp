@@ -0,0 +1,397 @@
+// Copyright 2022 Emmett Lalish
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstring>
+#include <limits>
+#include <unordered_set>
+
+#include "csg_tree.h"
+#include "impl.h"
+
+namespace {
+using namespace manifold;
+
+// Serialize() writes kMagic, kVersion and then the root node. Each node starts
+// with its Tag:
+//   LEAF_DATA     transform, hash, leaf blob
+//   LEAF_REF      transform, hash
+//   INSTANCES     count, then that many LEAF_DATA or LEAF_REF nodes
+//   UNION etc.    transform, count, then that many child nodes
+// A transform is a glm::mat4x3 and a hash is the 64-bit FNV-1a of the leaf
+// blob: precision, numVert, numTri, then the packed float positions and uint32
+// triangle indices. Every field is a multiple of four bytes, in host
+// (little-endian) order. FNV-1a detects corruption, but collisions are easy to
+// construct, so a LEAF_REF can only be trusted from a trusted sender.
+constexpr char kMagic[4] = {'M', 'C', 'S', 'G'};
+constexpr uint32_t kVersion = 1;
+// The reader accepts nodes nested at most this deep, which bounds its
+// recursion. The writer flattens the chains that repeated Boolean() calls
+// build, so ordinary trees stay far below it.
+constexpr int kMaxDepth = 1 << 10;
+
+enum class Tag : uint32_t {
+  LEAF_DATA,
+  LEAF_REF,
+  INSTANCES,
+  UNION,
+  DIFFERENCE,
+  INTERSECTION
+};
+
+uint64_t HashBytes(const char* data, size_t size) {
+  uint64_t hash = 14695981039346656037ull;
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+struct BlobIndexInRange {
+  const char* triVerts;
+  const uint32_t numVert;
+
+  __host__ __device__ bool operator()(int i) const {
+    uint32_t vert;
+    memcpy(&vert, triVerts + sizeof(uint32_t) * i, sizeof(uint32_t));
+    return vert < numVert;
+  }
+};
+
+class CsgWriter {
+ public:
+  explicit CsgWriter(const std::function<bool(uint64_t)>& embedLeaf)
+      : embedLeaf_(embedLeaf) {
+    out_.append(kMagic, sizeof(kMagic));
+    Put(kVersion);
+  }
+
+  std::string& Result() { return out_; }
+
+  void Node(const CsgNode& node) {
+    const CsgNodeType type = node.GetNodeType();
+    if (type == CsgNodeType::LEAF) {
+      const auto& leaf = static_cast<const CsgLeafNode&>(node);
+      const auto& instances = leaf.GetInstances();
+      if (instances.empty()) {
+        Leaf(leaf);
+        return;
+      }
+      Put(Tag::INSTANCES);
+      Put(static_cast<uint32_t>(instances.size()));
+      for (const auto& instance : instances) Leaf(*instance);
+      return;
+    }
+
+    const auto& op = static_cast<const CsgOpNode&>(node);
+    const std::vector<std::shared_ptr<CsgNode>> children = FlatChildren(op);
+    Put(type == CsgNodeType::UNION        ? Tag::UNION
+        : type == CsgNodeType::DIFFERENCE ? Tag::DIFFERENCE
+                                          : Tag::INTERSECTION);
+    Put(op.GetTransform());
+    Put(static_cast<uint32_t>(children.size()));
+    for (const auto& child : children) Node(*child);
+  }
+
+ private:
+  const std::function<bool(uint64_t)>& embedLeaf_;
+  std::string out_;
+  // leaves already hashed, which the tree keeps alive while writing
+  std::unordered_map<const Manifold::Impl*, uint64_t> hashes_;
+  // leaves already embedded or offered to embedLeaf_
+  std::unordered_set<uint64_t> written_;
+
+  /**
+   * The pending children of op, with those of untransformed children of the
+   * same operation inlined, as CsgOpNode::GetChildren() does, and for a
+   * difference only in the first child. So the chain `result += part` builds
+   * is written as one node, and without recursion.
+   */
+  static std::vector<std::shared_ptr<CsgNode>> FlatChildren(
+      const CsgOpNode& op) {
+    const CsgNodeType type = op.GetNodeType();
+    std::vector<std::shared_ptr<CsgNode>> children;
+    // in reverse order, so the next child is at the back
+    std::vector<std::shared_ptr<CsgNode>> stack;
+    auto expand = [&stack](const CsgOpNode& node) {
+      const std::vector<std::shared_ptr<CsgNode>> pending =
+          node.GetPendingChildren();
+      stack.insert(stack.end(), pending.rbegin(), pending.rend());
+    };
+    expand(op);
+    while (!stack.empty()) {
+      std::shared_ptr<CsgNode> child = std::move(stack.back());
+      stack.pop_back();
+      if (child->GetNodeType() == type &&
+          child->GetTransform() == glm::mat4x3(1.0f) &&
+          (type != CsgNodeType::DIFFERENCE || children.empty())) {
+        expand(static_cast<const CsgOpNode&>(*child));
+      } else {
+        children.push_back(std::move(child));
+      }
+    }
+    return children;
+  }
+
+  template <typename T>
+  void Put(const T& value) {
+    out_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  void Leaf(const CsgLeafNode& leaf) {
+    std::shared_ptr<const Manifold::Impl> pImpl = leaf.GetBaseImpl();
+    auto it = hashes_.find(pImpl.get());
+    std::string blob;
+    if (it == hashes_.end()) {
+      blob = Blob(*pImpl);
+      it = hashes_.emplace(pImpl.get(), HashBytes(blob.data(), blob.size()))
+               .first;
+    }
+    const uint64_t hash = it->second;
+    const bool embed = written_.insert(hash).second &&
+                       (embedLeaf_ == nullptr || embedLeaf_(hash));
+    Put(embed ? Tag::LEAF_DATA : Tag::LEAF_REF);
+    Put(leaf.GetTransform());
+    Put(hash);
+    if (embed) out_.append(blob);
+  }
+
+  static std::string Blob(const Manifold::Impl& impl) {
+    const uint32_t numVert = impl.NumVert();
+    const uint32_t numTri = impl.NumTri();
+    std::string blob;
+    blob.reserve(3 * sizeof(uint32_t) + 3 * sizeof(float) * numVert +
+                 3 * sizeof(uint32_t) * numTri);
+    blob.append(reinterpret_cast<const char*>(&impl.precision_),
+                sizeof(float));
+    blob.append(reinterpret_cast<const char*>(&numVert), sizeof(uint32_t));
+    blob.append(reinterpret_cast<const char*>(&numTri), sizeof(uint32_t));
+    blob.append(reinterpret_cast<const char*>(impl.vertPos_.cptrH()),
+                3 * sizeof(float) * numVert);
+    const Halfedge* halfedge = impl.halfedge_.cptrH();
+    for (uint32_t i = 0; i < 3 * numTri; ++i) {
+      const uint32_t vert = halfedge[i].startVert;
+      blob.append(reinterpret_cast<const char*>(&vert), sizeof(uint32_t));
+    }
+    return blob;
+  }
+};
+
+class CsgReader {
+ public:
+  CsgReader(
+      const std::string& data,
+      std::function<std::shared_ptr<const Manifold::Impl>(uint64_t)> findLeaf)
+      : data_(data), findLeaf_(std::move(findLeaf)) {
+    ALWAYS_ASSERT(data_.size() >= sizeof(kMagic) &&
+                      std::memcmp(data_.data(), kMagic, sizeof(kMagic)) == 0,
+                  userErr, "Not a serialized Manifold.");
+    pos_ = sizeof(kMagic);
+    ALWAYS_ASSERT(Get<uint32_t>() == kVersion, userErr,
+                  "Unsupported serialized Manifold version.");
+  }
+
+  std::shared_ptr<CsgNode> Root() {
+    std::shared_ptr<CsgNode> root = Node(0);
+    ALWAYS_ASSERT(pos_ == data_.size(), userErr,
+                  "Trailing bytes after serialized Manifold.");
+    return root;
+  }
+
+  // the leaves that were embedded, by hash
+  const std::unordered_map<uint64_t, std::shared_ptr<const Manifold::Impl>>&
+  Leaves() const {
+    return leaves_;
+  }
+
+ private:
+  const std::string& data_;
+  const std::function<std::shared_ptr<const Manifold::Impl>(uint64_t)>
+      findLeaf_;
+  size_t pos_ = 0;
+  std::unordered_map<uint64_t, std::shared_ptr<const Manifold::Impl>> leaves_;
+
+  const char* Take(size_t bytes) {
+    ALWAYS_ASSERT(bytes <= data_.size() - pos_, userErr,
+                  "Truncated serialized Manifold.");
+    const char* ptr = data_.data() + pos_;
+    pos_ += bytes;
+    return ptr;
+  }
+
+  template <typename T>
+  T Get() {
+    T value;
+    std::memcpy(&value, Take(sizeof(T)), sizeof(T));
+    return value;
+  }
+
+  std::shared_ptr<CsgNode> Node(int depth) {
+    ALWAYS_ASSERT(depth < kMaxDepth, userErr,
+                  "Serialized Manifold is nested too deeply.");
+    const Tag tag = Get<Tag>();
+    Manifold::OpType op;
+    switch (tag) {
+      case Tag::LEAF_DATA:
+      case Tag::LEAF_REF:
+        return Leaf(tag);
+      case Tag::INSTANCES: {
+        const uint32_t count = Get<uint32_t>();
+        ALWAYS_ASSERT(count > 0, userErr,
+                      "Serialized Manifold has an empty node.");
+        std::vector<std::shared_ptr<CsgLeafNode>> instances;
+        for (uint32_t i = 0; i < count; ++i) {
+          const Tag leafTag = Get<Tag>();
+          ALWAYS_ASSERT(leafTag == Tag::LEAF_DATA || leafTag == Tag::LEAF_REF,
+                        userErr, "Instances must be leaves.");
+          instances.push_back(Leaf(leafTag));
+        }
+        return std::make_shared<CsgLeafNode>(instances);
+      }
+      case Tag::UNION:
+        op = Manifold::OpType::ADD;
+        break;
+      case Tag::DIFFERENCE:
+        op = Manifold::OpType::SUBTRACT;
+        break;
+      case Tag::INTERSECTION:
+        op = Manifold::OpType::INTERSECT;
+        break;
+      default:
+        throw userErr("Unknown node in serialized Manifold.");
+    }
+    const glm::mat4x3 transform = Get<glm::mat4x3>();
+    const uint32_t count = Get<uint32_t>();
+    ALWAYS_ASSERT(count > 0, userErr, "Serialized Manifold has an empty node.");
+    std::vector<std::shared_ptr<CsgNode>> children;
+    for (uint32_t i = 0; i < count; ++i) children.push_back(Node(depth + 1));
+    std::shared_ptr<CsgNode> node =
+        std::make_shared<CsgOpNode>(std::move(children), op);
+    if (transform != glm::mat4x3(1.0f)) node = node->Transform(transform);
+    return node;
+  }
+
+  std::shared_ptr<CsgLeafNode> Leaf(Tag tag) {
+    const glm::mat4x3 transform = Get<glm::mat4x3>();
+    const uint64_t hash = Get<uint64_t>();
+    std::shared_ptr<const Manifold::Impl> pImpl;
+    if (tag == Tag::LEAF_DATA) {
+      pImpl = ReadBlob(hash);
+    } else {
+      auto it = leaves_.find(hash);
+      if (it != leaves_.end()) {
+        pImpl = it->second;
+      } else if (findLeaf_ != nullptr) {
+        pImpl = findLeaf_(hash);
+      }
+    }
+    ALWAYS_ASSERT(pImpl != nullptr, userErr,
+                  "Serialized Manifold refers to an unknown leaf.");
+    return std::make_shared<CsgLeafNode>(pImpl, transform);
+  }
+
+  std::shared_ptr<const Manifold::Impl> ReadBlob(uint64_t hash) {
+    const size_t start = pos_;
+    const float precision = Get<float>();
+    const uint32_t numVert = Get<uint32_t>();
+    const uint32_t numTri = Get<uint32_t>();
+    const char* vertPos = Take(3 * sizeof(float) * size_t(numVert));
+    const char* triVerts = Take(3 * sizeof(uint32_t) * size_t(numTri));
+    ALWAYS_ASSERT(HashBytes(data_.data() + start, pos_ - start) == hash,
+                  userErr, "Serialized Manifold leaf does not match its hash.");
+    auto it = leaves_.find(hash);
+    if (it != leaves_.end()) return it->second;
+
+    ALWAYS_ASSERT(numVert <= std::numeric_limits<int>::max() &&
+                      numTri <= std::numeric_limits<int>::max() / 3,
+                  userErr, "Serialized Manifold leaf is too large.");
+    const int numIndex = 3 * numTri;
+    ALWAYS_ASSERT(all_of(HostPolicy(numIndex), countAt(0), countAt(numIndex),
+                         BlobIndexInRange({triVerts, numVert})),
+                  userErr,
+                  "Serialized Manifold leaf has a vertex index out of range.");
+    std::shared_ptr<Manifold::Impl> pImpl;
+    if (numTri == 0) {
+      pImpl = std::make_shared<Manifold::Impl>();
+    } else {
+      MeshView view;
+      view.vertPos = vertPos;
+      view.numVert = numVert;
+      view.triVerts = triVerts;
+      view.numTri = numTri;
+      // The sender's precision applies to simplifying the leaf as well.
+      pImpl = std::make_shared<Manifold::Impl>(view, precision);
+    }
+    leaves_.emplace(hash, pImpl);
+    return pImpl;
+  }
+};
+}  // namespace
+
+namespace manifold {
+
+/**
+ * Writes the CSG tree of this Manifold without evaluating it, so that another
+ * process can evaluate it after Deserialize(). Operations and transforms are
+ * kept as they are, while each leaf mesh is written either as a blob of its
+ * positions and triangles, or only as the 64-bit content hash of that blob, for
+ * a receiver that already has it. A leaf found more than once is written once.
+ * Like a Mesh, this does not keep the mesh relation, tangents or properties.
+ *
+ * @param embedLeaf Called once with the hash of each distinct leaf, returning
+ * whether to embed it rather than write just its hash. By default, all leaves
+ * are embedded.
+ */
+std::string Manifold::Serialize(
+    const std::function<bool(uint64_t)>& embedLeaf) const {
+  CsgWriter writer(embedLeaf);
+  writer.Node(*std::atomic_load(&pNode_));
+  return std::move(writer.Result());
+}
+
+/**
+ * Rebuilds the lazy CSG tree written by Serialize(), so that it is evaluated
+ * only when needed, as usual. Throws a userErr if the data is malformed or
+ * refers to a leaf it does not contain and that is not in leafCache.
+ *
+ * @param data The output of Serialize().
+ * @param leafCache Optional leaves by hash, to look up those written only by
+ * hash. The embedded leaves are added to it, so that a worker keeping it
+ * between calls needs each leaf sent only once. The hash is not
+ * cryptographic, so a sender can craft a leaf that replaces another in the
+ * cache: share a cache only between trusted senders.
+ */
+Manifold Manifold::Deserialize(
+    const std::string& data,
+    std::unordered_map<uint64_t, Manifold>* leafCache) {
+  auto findLeaf = [leafCache](uint64_t hash) {
+    std::shared_ptr<const Impl> pImpl;
+    if (leafCache == nullptr) return pImpl;
+    auto it = leafCache->find(hash);
+    if (it != leafCache->end()) pImpl = it->second.GetCsgLeafNode().GetImpl();
+    return pImpl;
+  };
+  CsgReader reader(data, findLeaf);
+  Manifold result(reader.Root());
+  if (leafCache != nullptr) {
+    for (const auto& leaf : reader.Leaves()) {
+      std::shared_ptr<CsgNode> node =
+          std::make_shared<CsgLeafNode>(leaf.second);
+      leafCache->emplace(leaf.first, Manifold(node));
+    }
+  }
+  return result;
+}
+
+}  // namespace manifold
@@ -114,6 +114,73 @@ __host__ __device__ inline glm::vec3 GetBarycentric(const glm::vec3& v,
   }
 }
 
+/**
+ * Returns true if the projections of the two triangles onto this axis overlap
+ * by no more than precision. A zero-length axis never separates.
+ */
+__host__ __device__ inline bool SeparatedAlong(glm::vec3 axis,
+                                               const glm::vec3* triA,
+                                               const glm::vec3* triB,
+                                               float precision) {
+  const float length = glm::length(axis);
+  if (!(length > 0)) return false;
+  axis /= length;
+  glm::vec2 rangeA(glm::dot(axis, triA[0]));
+  glm::vec2 rangeB(glm::dot(axis, triB[0]));
+  for (int i : {1, 2}) {
+    const float a = glm::dot(axis, triA[i]);
+    const float b = glm::dot(axis, triB[i]);
+    rangeA = glm::vec2(glm::min(rangeA[0], a), glm::max(rangeA[1], a));
+    rangeB = glm::vec2(glm::min(rangeB[0], b), glm::max(rangeB[1], b));
+  }
+  return rangeA[1] - rangeB[0] <= precision ||
+         rangeB[1] - rangeA[0] <= precision;
+}
+
+/**
+ * Separating-axis test of two triangles, checking both normals, the nine
+ * edge-edge cross products, and the in-plane edge normals of each. Triangles
+ * that only touch (including coplanar overlap) within precision are not
+ * considered intersecting, in keeping with the epsilon-valid definition.
+ */
+__host__ __device__ inline bool TrianglesIntersect(const glm::vec3* triA,
+                                                   const glm::vec3* triB,
+                                                   float precision) {
+  glm::vec3 edgeA[3];
+  glm::vec3 edgeB[3];
+  for (int i : {0, 1, 2}) {
+    const int j = i == 2 ? 0 : i + 1;
+    edgeA[i] = triA[j] - triA[i];
+    edgeB[i] = triB[j] - triB[i];
+  }
+  const glm::vec3 normalA = glm::cross(edgeA[0], edgeA[1]);
+  const glm::vec3 normalB = glm::cross(edgeB[0], edgeB[1]);
+  if (SeparatedAlong(normalA, triA, triB, precision) ||
+      SeparatedAlong(normalB, triA, triB, precision))
+    return false;
+  for (int i : {0, 1, 2}) {
+    for (int j : {0, 1, 2}) {
+      if (SeparatedAlong(glm::cross(edgeA[i], edgeB[j]), triA, triB, precision))
+        return false;
+    }
+  }
+  for (int i : {0, 1, 2}) {
+    if (SeparatedAlong(glm::cross(normalA, edgeA[i]), triA, triB, precision) ||
+        SeparatedAlong(glm::cross(normalB, edgeB[i]), triA, triB, precision))
+      return false;
+  }
+  return true;
+}
+
+/**
+ * Caller-owned buffers are not device memory, so a CUDA build still accesses
+ * them on the host.
+ */
+inline ExecutionPolicy HostPolicy(int size) {
+  const ExecutionPolicy policy = autoPolicy(size);
+  return policy == ExecutionPolicy::ParUnseq ? ExecutionPolicy::Par : policy;
+}
+
 /**
  * This is a temporary edge strcture which only stores edges forward and
  * references the halfedge it was created from.
@@ -483,12 +483,12 @@ Manifold::Impl::MeshRelationD Manifold::Impl::Subdivide(int n) {
   for_each_n(policy, zip(countAt(0), edges.begin()), numEdge,
              EdgeVerts({vertPos_.ptrD(), numVert, n}));
   for_each_n(
-      policy, zip(countAt(0), oldMeshRelation.triBary.begin()), numTri,
+      policy, zip(countAt(0), oldMeshRelation.triBary.cbegin()), numTri,
       InteriorVerts({vertPos_.ptrD(), relation.barycentric.ptrD(),
                      relation.triBary.ptrD(), meshRelation_.barycentric.ptrD(),
                      meshRelation_.triBary.ptrD(),
                      oldMeshRelation.barycentric.cptrD(), triVertStart, n,
-                     halfedge_.ptrD()}));
+                     halfedge_.cptrD()}));
   // Create subtriangles
   VecDH<glm::ivec3> triVerts(n * n * numTri);
   for_each_n(policy, countAt(0), numTri,
@@ -20,8 +20,6 @@
 namespace {
 using namespace manifold;
 
-constexpr uint32_t kNoCode = 0xFFFFFFFFu;
-
 struct Extrema : public thrust::binary_function<Halfedge, Halfedge, Halfedge> {
   __host__ __device__ void MakeForward(Halfedge& a) {
     if (!a.IsForward()) {
@@ -46,27 +44,6 @@ struct Extrema : public thrust::binary_function<Halfedge, Halfedge, Halfedge> {
   }
 };
 
-__host__ __device__ uint32_t SpreadBits3(uint32_t v) {
-  v = 0xFF0000FFu & (v * 0x00010001u);
-  v = 0x0F00F00Fu & (v * 0x00000101u);
-  v = 0xC30C30C3u & (v * 0x00000011u);
-  v = 0x49249249u & (v * 0x00000005u);
-  return v;
-}
-
-__host__ __device__ uint32_t MortonCode(glm::vec3 position, Box bBox) {
-  // Unreferenced vertices are marked NaN, and this will sort them to the end
-  // (the Morton code only uses the first 30 of 32 bits).
-  if (isnan(position.x)) return kNoCode;
-
-  glm::vec3 xyz = (position - bBox.min) / (bBox.max - bBox.min);
-  xyz = glm::min(glm::vec3(1023.0f), glm::max(glm::vec3(0.0f), 1024.0f * xyz));
-  uint32_t x = SpreadBits3(static_cast<uint32_t>(xyz.x));
-  uint32_t y = SpreadBits3(static_cast<uint32_t>(xyz.y));
-  uint32_t z = SpreadBits3(static_cast<uint32_t>(xyz.z));
-  return x * 4 + y * 2 + z;
-}
-
 struct Morton {
   const Box bBox;
 
@@ -109,6 +86,18 @@ struct FaceMortonBox {
   }
 };
 
+struct RemovedHalfedge {
+  __host__ __device__ bool operator()(const Halfedge& edge) {
+    return edge.pairedHalfedge < 0;
+  }
+};
+
+struct RemovedVert {
+  __host__ __device__ bool operator()(const glm::vec3& pos) {
+    return isnan(pos.x);
+  }
+};
+
 struct Reindex {
   const int* indexInv;
 
@@ -119,6 +108,268 @@ struct Reindex {
   }
 };
 
+// Cells per axis of the welding grid; each cell index takes 21 bits of a
+// 64-bit Morton code, leaving room for the neighbors of the last cell.
+constexpr int kWeldCells = 1 << 20;
+constexpr uint64_t kNoCell = ~uint64_t(0);
+
+__host__ __device__ uint64_t SpreadBits21(uint64_t v) {
+  v = v & 0x1FFFFFull;
+  v = (v | v << 32) & 0x1F00000000FFFFull;
+  v = (v | v << 16) & 0x1F0000FF0000FFull;
+  v = (v | v << 8) & 0x100F00F00F00F00Full;
+  v = (v | v << 4) & 0x10C30C30C30C30C3ull;
+  v = (v | v << 2) & 0x1249249249249249ull;
+  return v;
+}
+
+__host__ __device__ uint64_t CellCode(glm::ivec3 cell) {
+  return SpreadBits21(cell.x) << 2 | SpreadBits21(cell.y) << 1 |
+         SpreadBits21(cell.z);
+}
+
+__host__ __device__ glm::ivec3 CellOf(glm::vec3 pos, glm::vec3 origin,
+                                      float cellSize) {
+  return glm::clamp(glm::ivec3((pos - origin) / cellSize), glm::ivec3(0),
+                    glm::ivec3(kWeldCells - 1));
+}
+
+struct WeldCell {
+  const glm::vec3 origin;
+  const float cellSize;
+
+  __host__ __device__ void operator()(
+      thrust::tuple<uint64_t&, const glm::vec3&> inout) {
+    const glm::vec3 pos = thrust::get<1>(inout);
+    thrust::get<0>(inout) =
+        isnan(pos.x) ? kNoCell : CellCode(CellOf(pos, origin, cellSize));
+  }
+};
+
+/**
+ * Finds the lowest label among each vertex and those within tolerance of it by
+ * searching its own and, for a nonzero tolerance, the 26 neighboring cells of
+ * the sorted grid.
+ */
+struct WeldNeighbor {
+  int* nextRep;
+  const int* rep;
+  const uint64_t* cellCode;
+  const int* cellVert;
+  const glm::vec3* vertPos;
+  const int numVert;
+  const glm::vec3 origin;
+  const float cellSize;
+  const float tolerance;
+
+  __host__ __device__ int LowerBound(uint64_t code) {
+    int lo = 0;
+    int hi = numVert;
+    while (lo < hi) {
+      const int mid = (lo + hi) / 2;
+      if (cellCode[mid] < code)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    return lo;
+  }
+
+  __host__ __device__ void operator()(int vert) {
+    int& label = nextRep[vert];
+    label = rep[vert];
+    const glm::vec3 pos = vertPos[vert];
+    if (isnan(pos.x)) return;
+
+    const glm::ivec3 cell = CellOf(pos, origin, cellSize);
+    const int reach = tolerance > 0 ? 1 : 0;
+    for (int i = -reach; i <= reach; ++i) {
+      for (int j = -reach; j <= reach; ++j) {
+        for (int k = -reach; k <= reach; ++k) {
+          const glm::ivec3 neighbor = cell + glm::ivec3(i, j, k);
+          if (glm::any(glm::lessThan(neighbor, glm::ivec3(0)))) continue;
+          const uint64_t code = CellCode(neighbor);
+          for (int s = LowerBound(code); s < numVert && cellCode[s] == code;
+               ++s) {
+            const int other = cellVert[s];
+            if (rep[other] < label &&
+                glm::dot(vertPos[other] - pos, vertPos[other] - pos) <=
+                    tolerance * tolerance)
+              label = rep[other];
+          }
+        }
+      }
+    }
+  }
+};
+
+struct FollowRep {
+  const int* rep;
+
+  __host__ __device__ int operator()(int vert) { return rep[vert]; }
+};
+
+struct SameRep {
+  __host__ __device__ bool operator()(thrust::tuple<int, int> reps) {
+    return thrust::get<0>(reps) == thrust::get<1>(reps);
+  }
+};
+
+struct IsRep {
+  const int* rep;
+
+  __host__ __device__ int operator()(int vert) { return rep[vert] == vert; }
+};
+
+struct WeldTri {
+  const int* rep;
+  const int* newVert;
+
+  __host__ __device__ void operator()(glm::ivec3& tri) {
+    for (const int i : {0, 1, 2}) tri[i] = newVert[rep[tri[i]]];
+  }
+};
+
+struct CollapsedTri {
+  __host__ __device__ bool operator()(const glm::ivec3& tri) {
+    return tri[0] == tri[1] || tri[1] == tri[2] || tri[2] == tri[0];
+  }
+};
+
+// Triangles reordered together. Morton-sorted triangles are spatially
+// clustered, so this costs few extra cache misses at the seams.
+constexpr int kRenderCluster = 1 << 12;
+// Vertices in the simulated post-transform cache.
+constexpr int kVertexCache = 16;
+
+struct ClusterKey {
+  const glm::ivec3* triVerts;
+
+  __host__ __device__ void operator()(thrust::tuple<uint64_t&, int> inOut) {
+    const int corner = thrust::get<1>(inOut);
+    const int tri = corner / 3;
+    thrust::get<0>(inOut) = static_cast<uint64_t>(tri / kRenderCluster) << 32 |
+                            triVerts[tri][corner % 3];
+  }
+};
+
+/**
+ * Orders each cluster's triangles with Tipsify (Sander et al. 2007): fan
+ * around a vertex, then move to the neighbor that will still be in the cache,
+ * falling back to recently used vertices and then to any unfinished one. The
+ * corners are sorted by cluster and vertex, so each cluster owns the same
+ * range of every per-corner array and its vertices are runs within it.
+ */
+struct Tipsify {
+  int* triNew2Old;
+  int* cornerRun;
+  int* runEnd;
+  int* live;
+  int* cacheTime;
+  int* deadEnd;
+  int* emitted;
+  const uint64_t* key;
+  const int* corner;
+  int numTri;
+
+  __host__ __device__ void operator()(int cluster) {
+    const int firstTri = cluster * kRenderCluster;
+    const int begin = 3 * firstTri;
+    const int end = 3 * glm::min(numTri, firstTri + kRenderCluster);
+    int run = begin;
+    for (int i = begin; i < end; ++i) {
+      if (key[i] != key[run]) {
+        runEnd[run] = i;
+        run = i;
+      }
+      cornerRun[corner[i]] = run;
+      ++live[run];
+    }
+    runEnd[run] = end;
+
+    int output = firstTri;
+    int deadEndTop = begin;
+    int cursor = begin;
+    int time = kVertexCache + 1;
+    int vert = begin;
+    while (vert >= 0) {
+      const int candidates = deadEndTop;
+      for (int i = vert; i < runEnd[vert]; ++i) {
+        const int tri = corner[i] / 3;
+        if (emitted[tri]) continue;
+        emitted[tri] = 1;
+        triNew2Old[output++] = tri;
+        for (const int j : {0, 1, 2}) {
+          const int v = cornerRun[3 * tri + j];
+          deadEnd[deadEndTop++] = v;
+          --live[v];
+          if (time - cacheTime[v] > kVertexCache) cacheTime[v] = time++;
+        }
+      }
+
+      vert = -1;
+      int bestPriority = -1;
+      for (int i = candidates; i < deadEndTop; ++i) {
+        const int v = deadEnd[i];
+        if (live[v] == 0) continue;
+        const int age = time - cacheTime[v];
+        const int priority = age + 2 * live[v] <= kVertexCache ? age : 0;
+        if (priority > bestPriority) {
+          bestPriority = priority;
+          vert = v;
+        }
+      }
+      while (vert < 0 && deadEndTop > begin) {
+        const int v = deadEnd[--deadEndTop];
+        if (live[v] > 0) vert = v;
+      }
+      while (vert < 0 && cursor < end) {
+        if (live[cursor] > 0) vert = cursor;
+        ++cursor;
+      }
+    }
+  }
+};
+
+struct GatherTri {
+  glm::vec4* halfedgeTangent;
+  const glm::vec4* oldHalfedgeTangent;
+
+  __host__ __device__ void operator()(thrust::tuple<int, int> newOld) {
+    for (const int i : {0, 1, 2})
+      halfedgeTangent[3 * thrust::get<0>(newOld) + i] =
+          oldHalfedgeTangent[3 * thrust::get<1>(newOld) + i];
+  }
+};
+
+struct UseKey {
+  const glm::ivec3* triVerts;
+
+  __host__ __device__ uint64_t operator()(int corner) {
+    return static_cast<uint64_t>(triVerts[corner / 3][corner % 3]) << 32 |
+           corner;
+  }
+};
+
+struct FirstUse {
+  int* firstUse;
+  const uint64_t* useKey;
+
+  __host__ __device__ void operator()(int i) {
+    const int vert = useKey[i] >> 32;
+    if (i == 0 || (useKey[i - 1] >> 32) != vert)
+      firstUse[vert] = useKey[i] & 0xFFFFFFFF;
+  }
+};
+
+struct ReindexTri {
+  const int* vertOld2New;
+
+  __host__ __device__ void operator()(glm::ivec3& tri) {
+    for (const int i : {0, 1, 2}) tri[i] = vertOld2New[tri[i]];
+  }
+};
+
 template <typename T>
 void Permute(VecDH<T>& inOut, const VecDH<int>& new2Old) {
   VecDH<T> tmp(std::move(inOut));
@@ -156,6 +407,30 @@ struct ReindexFace {
   }
 };
 
+/**
+ * Checks that every index of the halfedges is in range, so that a corrupted
+ * mesh fails here rather than in a later out-of-bounds access.
+ */
+void CheckIndices(const VecDH<Halfedge>& halfedge, int numVert) {
+  ALWAYS_ASSERT(halfedge.size() % 6 == 0, topologyErr,
+                "Not an even number of faces after sorting faces!");
+  Halfedge extrema = {0, 0, 0, 0};
+  extrema = reduce<Halfedge>(autoPolicy(halfedge.size(), OpKind::Reduce),
+                             halfedge.begin(), halfedge.end(), extrema,
+                             Extrema());
+
+  ALWAYS_ASSERT(extrema.startVert >= 0, topologyErr,
+                "Vertex index is negative!");
+  ALWAYS_ASSERT(extrema.endVert < numVert, topologyErr,
+                "Vertex index exceeds number of verts!");
+  ALWAYS_ASSERT(extrema.face >= 0, topologyErr, "Face index is negative!");
+  ALWAYS_ASSERT(extrema.face < halfedge.size() / 3, topologyErr,
+                "Face index exceeds number of faces!");
+  ALWAYS_ASSERT(extrema.pairedHalfedge >= 0, topologyErr,
+                "Halfedge index is negative!");
+  ALWAYS_ASSERT(extrema.pairedHalfedge < halfedge.size(), topologyErr,
+                "Halfedge index exceeds number of halfedges!");
+}
 }  // namespace
 
 namespace manifold {
@@ -167,6 +442,7 @@ namespace manifold {
  */
 void Manifold::Impl::Finish() {
   if (halfedge_.size() == 0) return;
+  TraceScope trace("Finish");
 
   CalculateBBox();
   SetPrecision(precision_);
@@ -184,28 +460,48 @@ void Manifold::Impl::Finish() {
   SortFaces(faceBox, faceMorton);
   if (halfedge_.size() == 0) return;
 
-  ALWAYS_ASSERT(halfedge_.size() % 6 == 0, topologyErr,
-                "Not an even number of faces after sorting faces!");
-  Halfedge extrema = {0, 0, 0, 0};
-  extrema = reduce<Halfedge>(autoPolicy(halfedge_.size()), halfedge_.begin(),
-                             halfedge_.end(), extrema, Extrema());
-
-  ALWAYS_ASSERT(extrema.startVert >= 0, topologyErr,
-                "Vertex index is negative!");
-  ALWAYS_ASSERT(extrema.endVert < NumVert(), topologyErr,
-                "Vertex index exceeds number of verts!");
-  ALWAYS_ASSERT(extrema.face >= 0, topologyErr, "Face index is negative!");
-  ALWAYS_ASSERT(extrema.face < NumTri(), topologyErr,
-                "Face index exceeds number of faces!");
-  ALWAYS_ASSERT(extrema.pairedHalfedge >= 0, topologyErr,
-                "Halfedge index is negative!");
-  ALWAYS_ASSERT(extrema.pairedHalfedge < 2 * NumEdge(), topologyErr,
-                "Halfedge index exceeds number of halfedges!");
+  CheckIndices(halfedge_, NumVert());
 
   CalculateNormals();
   collider_ = Collider(faceBox, faceMorton);
 }
 
+/**
+ * A cheaper version of Finish() for the result of Compose(), whose parts were
+ * each already sorted and given a collider. If nothing was flagged for
+ * removal, the sorting is skipped and the parts' colliders, given in order, are
+ * grafted under a new top-level tree instead of building one from scratch.
+ * Returns false without changing anything if this shortcut does not apply,
+ * including when repeated grafting would make the tree too deep, in which case
+ * Finish() should be called instead.
+ */
+bool Manifold::Impl::FinishComposed(
+    const std::vector<const Collider*>& colliders) {
+  if (halfedge_.size() == 0 || !Collider::CanGraft(colliders)) return false;
+  if (count_if(autoPolicy(halfedge_.size()), halfedge_.cbegin(),
+               halfedge_.cend(), RemovedHalfedge()) > 0 ||
+      count_if(autoPolicy(NumVert()), vertPos_.cbegin(), vertPos_.cend(),
+               RemovedVert()) > 0)
+    return false;
+
+  const Box oldBox = bBox_;
+  const float oldPrecision = precision_;
+  CalculateBBox();
+  if (!bBox_.isFinite()) {
+    bBox_ = oldBox;
+    return false;
+  }
+  SetPrecision(oldPrecision);
+  CheckIndices(halfedge_, NumVert());
+
+  CalculateNormals();
+  VecDH<Box> faceBox;
+  VecDH<uint32_t> faceMorton;
+  GetFaceBoxMorton(faceBox, faceMorton);
+  collider_ = Collider(colliders, faceBox);
+  return true;
+}
+
 /**
  * Sorts the vertices according to their Morton code.
  */
@@ -217,8 +513,8 @@ void Manifold::Impl::SortVerts() {
 
   VecDH<int> vertNew2Old(NumVert());
   sequence(policy, vertNew2Old.begin(), vertNew2Old.end());
-  sort_by_key(policy, vertMorton.begin(), vertMorton.end(),
-              zip(vertPos_.begin(), vertNew2Old.begin()));
+  sort_by_key(autoPolicy(NumVert(), OpKind::Sort), vertMorton.begin(),
+              vertMorton.end(), zip(vertPos_.begin(), vertNew2Old.begin()));
 
   ReindexVerts(vertNew2Old, NumVert());
 
@@ -245,6 +541,147 @@ void Manifold::Impl::ReindexVerts(const VecDH<int>& vertNew2Old,
            Reindex({vertOld2New.cptrD()}));
 }
 
+/**
+ * Merges each vertex into the lowest-indexed vertex within tolerance of it,
+ * which also chains through vertices that are each within tolerance of the
+ * next. The surviving vertices keep their relative order, triVerts is
+ * reindexed to them and the triangles this collapses are removed. The
+ * vertices are sorted into a grid of cells no smaller than tolerance by their
+ * Morton code, so each one only needs to search its neighboring cells.
+ */
+void Manifold::Impl::WeldVerts(VecDH<glm::ivec3>& triVerts, float tolerance) {
+  const int numVert = NumVert();
+  if (numVert == 0) return;
+  CalculateBBox();
+  ALWAYS_ASSERT(bBox_.isFinite(), userErr,
+                "Vertex positions must be finite to be welded.");
+  const glm::vec3 size = bBox_.Size();
+  float cellSize =
+      glm::max(tolerance, glm::max(size.x, glm::max(size.y, size.z)) /
+                              (kWeldCells - 1));
+  if (cellSize <= 0) cellSize = 1;
+
+  VecDH<uint64_t> cellCode(numVert);
+  VecDH<int> cellVert(numVert);
+  auto policy = autoPolicy(numVert);
+  for_each_n(policy, zip(cellCode.begin(), vertPos_.cbegin()), numVert,
+             WeldCell({bBox_.min, cellSize}));
+  sequence(policy, cellVert.begin(), cellVert.end());
+  sort_by_key(autoPolicy(numVert, OpKind::Sort), cellCode.begin(),
+              cellCode.end(), cellVert.begin());
+
+  // Each vertex is labeled by a vertex of its cluster, starting with itself.
+  // Every round, it takes the lowest label of the vertices within tolerance,
+  // and then the label of that label, which shortcuts long chains. The labels
+  // only decrease, so when a round changes none, each cluster is labeled by
+  // its lowest vertex, even where two of its vertices are too far apart to be
+  // merged directly.
+  VecDH<int> rep(numVert);
+  VecDH<int> nextRep(numVert);
+  VecDH<int> jumpRep(numVert);
+  sequence(policy, rep.begin(), rep.end());
+  while (true) {
+    for_each_n(policy, countAt(0), numVert,
+               WeldNeighbor({nextRep.ptrD(), rep.cptrD(), cellCode.cptrD(),
+                             cellVert.cptrD(), vertPos_.cptrD(), numVert,
+                             bBox_.min, cellSize, glm::max(tolerance, 0.0f)}));
+    transform(policy, nextRep.cbegin(), nextRep.cend(), jumpRep.begin(),
+              FollowRep({nextRep.cptrD()}));
+    if (all_of(policy, zip(rep.cbegin(), jumpRep.cbegin()),
+               zip(rep.cend(), jumpRep.cend()), SameRep()))
+      break;
+    rep.swap(jumpRep);
+  }
+
+  VecDH<int> newVert(numVert + 1, 0);
+  auto keepVert =
+      thrust::make_transform_iterator(countAt(0), IsRep({rep.cptrD()}));
+  inclusive_scan(autoPolicy(numVert, OpKind::Scan), keepVert,
+                 keepVert + numVert, newVert.begin() + 1);
+  const int numNewVert = newVert.back();
+
+  VecDH<glm::vec3> oldVertPos(std::move(vertPos_));
+  vertPos_.resize(numNewVert);
+  copy_if<decltype(vertPos_.begin())>(policy, oldVertPos.cbegin(),
+                                      oldVertPos.cend(), keepVert,
+                                      vertPos_.begin(),
+                                      thrust::identity<bool>());
+
+  for_each(autoPolicy(triVerts.size()), triVerts.begin(), triVerts.end(),
+           WeldTri({rep.cptrD(), newVert.cptrD()}));
+  const int numTri =
+      remove_if<decltype(triVerts.begin())>(autoPolicy(triVerts.size()),
+                                            triVerts.begin(), triVerts.end(),
+                                            CollapsedTri()) -
+      triVerts.begin();
+  triVerts.resize(numTri);
+}
+
+/**
+ * Reorders triVerts for the post-transform vertex cache of a GPU, along with
+ * halfedgeTangent_ if present, and then the vertices into the order they are
+ * first used, for locality of vertex fetch. Triangles are only reordered
+ * within clusters of consecutive ones, which are processed in parallel; these
+ * are spatially compact when the triangles are Morton-sorted, as Finish()
+ * leaves them.
+ */
+void Manifold::Impl::ReorderForRendering(VecDH<glm::ivec3>& triVerts) {
+  const int numTri = triVerts.size();
+  const int numCorner = 3 * numTri;
+  const int numVert = NumVert();
+  if (numTri == 0) return;
+  auto policy = autoPolicy(numCorner);
+
+  VecDH<uint64_t> key(numCorner);
+  VecDH<int> corner(numCorner);
+  for_each_n(policy, zip(key.begin(), countAt(0)), numCorner,
+             ClusterKey({triVerts.cptrD()}));
+  sequence(policy, corner.begin(), corner.end());
+  sort_by_key(autoPolicy(numCorner, OpKind::Sort), key.begin(), key.end(),
+              corner.begin());
+
+  VecDH<int> triNew2Old(numTri);
+  VecDH<int> cornerRun(numCorner), runEnd(numCorner), live(numCorner, 0),
+      cacheTime(numCorner, 0), deadEnd(numCorner), emitted(numTri, 0);
+  const int numCluster = (numTri + kRenderCluster - 1) / kRenderCluster;
+  for_each_n(policy, countAt(0), numCluster,
+             Tipsify({triNew2Old.ptrD(), cornerRun.ptrD(), runEnd.ptrD(),
+                      live.ptrD(), cacheTime.ptrD(), deadEnd.ptrD(),
+                      emitted.ptrD(), key.cptrD(), corner.cptrD(), numTri}));
+
+  Permute(triVerts, triNew2Old);
+  if (halfedgeTangent_.size() == numCorner) {
+    VecDH<glm::vec4> oldHalfedgeTangent(std::move(halfedgeTangent_));
+    halfedgeTangent_.resize(numCorner);
+    for_each_n(autoPolicy(numTri), zip(countAt(0), triNew2Old.begin()),
+               numTri,
+               GatherTri({halfedgeTangent_.ptrD(),
+                          oldHalfedgeTangent.cptrD()}));
+  }
+
+  // The first corner of each vertex, in the new triangle order, sorts first.
+  // Unused vertices keep their relative order at the end.
+  auto useKey = thrust::make_transform_iterator(countAt(0),
+                                                UseKey({triVerts.cptrD()}));
+  copy(policy, useKey, useKey + numCorner, key.begin());
+  sort(autoPolicy(numCorner, OpKind::Sort), key.begin(), key.end());
+  VecDH<int> firstUse(numVert, numCorner);
+  for_each_n(policy, countAt(0), numCorner,
+             FirstUse({firstUse.ptrD(), key.cptrD()}));
+
+  VecDH<int> vertNew2Old(numVert);
+  sequence(autoPolicy(numVert), vertNew2Old.begin(), vertNew2Old.end());
+  stable_sort_by_key(autoPolicy(numVert, OpKind::Sort), firstUse.begin(),
+                     firstUse.end(), vertNew2Old.begin());
+  VecDH<int> vertOld2New(numVert);
+  scatter(autoPolicy(numVert), countAt(0), countAt(numVert),
+          vertNew2Old.begin(), vertOld2New.begin());
+  for_each(autoPolicy(numTri), triVerts.begin(), triVerts.end(),
+           ReindexTri({vertOld2New.cptrD()}));
+  Permute(vertPos_, vertNew2Old);
+  if (vertNormal_.size() == numVert) Permute(vertNormal_, vertNew2Old);
+}
+
 /**
  * Fills the faceBox and faceMorton input with the bounding boxes and Morton
  * codes of the faces, respectively. The Morton code is based on the center of
@@ -269,8 +706,8 @@ void Manifold::Impl::SortFaces(VecDH<Box>& faceBox,
   auto policy = autoPolicy(faceNew2Old.size());
   sequence(policy, faceNew2Old.begin(), faceNew2Old.end());
 
-  sort_by_key(policy, faceMorton.begin(), faceMorton.end(),
-              zip(faceBox.begin(), faceNew2Old.begin()));
+  sort_by_key(autoPolicy(NumTri(), OpKind::Sort), faceMorton.begin(),
+              faceMorton.end(), zip(faceBox.begin(), faceNew2Old.begin()));
 
   // Tris were flagged for removal with pairedHalfedge = -1 and assigned kNoCode
   // to sort them to the end, which allows them to be removed.
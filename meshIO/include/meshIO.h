@@ -17,6 +17,8 @@
 
 namespace manifold {
 
+class Manifold;
+
 /** @addtogroup Connections
  *  @{
  */
@@ -39,12 +41,19 @@ struct Material {
 };
 
 /**
- * These options only currently affect .glb and .gltf files.
+ * These options only currently affect .glb, .gltf and .ply files.
  */
 struct ExportOptions {
   /// When false, vertex normals are exported, causing the mesh to appear smooth
   /// through normal interpolation.
   bool faceted = true;
+  /// For .glb, stores positions as 16-bit integers, normals and colors as
+  /// normalized bytes and small meshes' indices as 16-bit, using
+  /// KHR_mesh_quantization.
+  bool quantize = false;
+  /// For .glb, compresses the buffers with meshoptimizer's codecs, using
+  /// EXT_meshopt_compression.
+  bool compress = false;
   /// PBR material properties.
   Material mat = {};
 };
@@ -53,5 +62,8 @@ Mesh ImportMesh(const std::string& filename, bool forceCleanup = false);
 
 void ExportMesh(const std::string& filename, const Mesh& mesh,
                 const ExportOptions& options);
+
+void ExportMesh(const std::string& filename, const Manifold& manifold,
+                const ExportOptions& options);
 /** @} */
 }  // namespace manifold
\ No newline at end of file
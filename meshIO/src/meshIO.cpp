@@ -15,12 +15,15 @@
 #include "meshIO.h"
 
 #include <algorithm>
+#include <cctype>
 
 #include "assimp/Exporter.hpp"
 #include "assimp/GltfMaterial.h"
 #include "assimp/Importer.hpp"
 #include "assimp/postprocess.h"
 #include "assimp/scene.h"
+#include "manifold.h"
+#include "native_io.h"
 
 namespace manifold {
 
@@ -34,6 +37,10 @@ namespace manifold {
  * read all the important properties for their application and set up any custom
  * data structures.
  *
+ * STL, PLY and OBJ files are read in parallel straight from a memory mapping
+ * of the file, which is much faster for large scans; other formats go through
+ * Assimp.
+ *
  * @param filename Supports any format the Assimp library supports.
  * @param forceCleanup This merges identical vertices, which can break
  * manifoldness. However it is always done for STLs, as they cannot possibly be
@@ -41,8 +48,15 @@ namespace manifold {
  */
 Mesh ImportMesh(const std::string& filename, bool forceCleanup) {
   std::string ext = filename.substr(filename.find_last_of(".") + 1);
+  std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
   const bool isYup = ext == "glb" || ext == "gltf";
 
+  Mesh mesh_out;
+  if (ImportNative(filename, ext, mesh_out)) {
+    if (forceCleanup || ext == "stl") mesh_out = WeldVertices(mesh_out);
+    return mesh_out;
+  }
+
   Assimp::Importer importer;
   importer.SetPropertyInteger(AI_CONFIG_PP_RVC_FLAGS,                    //
                               aiComponent_NORMALS |                      //
@@ -70,7 +84,6 @@ Mesh ImportMesh(const std::string& filename, bool forceCleanup) {
 
   ALWAYS_ASSERT(scene, userErr, importer.GetErrorString());
 
-  Mesh mesh_out;
   for (int i = 0; i < scene->mNumMeshes; ++i) {
     const aiMesh* mesh_i = scene->mMeshes[i];
     for (int j = 0; j < mesh_i->mNumVertices; ++j) {
@@ -198,4 +211,29 @@ void ExportMesh(const std::string& filename, const Mesh& mesh,
   ALWAYS_ASSERT(result == AI_SUCCESS, userErr, exporter.GetErrorString());
 }
 
+/**
+ * Saves the Manifold to the desired file type, determined from the extension
+ * specified. Binary STL, binary PLY, GLB and 3MF files are written directly
+ * from the Manifold in chunks, encoded in parallel, which keeps the memory of
+ * large exports bounded; other formats go through GetMesh() and Assimp.
+ *
+ * @param filename The file extension must be stl, ply, glb, 3mf or one that
+ * Assimp supports for export.
+ * @param manifold The manifold to export.
+ * @param options The options affect an exported GLB's material and normals
+ * and a PLY's normals and vertex colors. Pass {} for defaults.
+ */
+void ExportMesh(const std::string& filename, const Manifold& manifold,
+                const ExportOptions& options) {
+  if (manifold.NumTri() == 0) {
+    std::cout << filename << " was not saved because the input mesh was empty."
+              << std::endl;
+    return;
+  }
+  std::string ext = filename.substr(filename.find_last_of(".") + 1);
+  std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+  if (!ExportNative(filename, ext, manifold, options))
+    ExportMesh(filename, manifold.GetMesh(), options);
+}
+
 }  // namespace manifold
@@ -0,0 +1,1800 @@
+// Copyright 2022 Emmett Lalish
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "native_io.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "context.h"
+#include "manifold.h"
+#include "par.h"
+#include "utils.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+using namespace manifold;
+
+// Below this many bytes or items per chunk, chunking costs more than it
+// saves.
+constexpr size_t kMinChunk = 1 << 16;
+
+int NumThreads() {
+  int threads = std::thread::hardware_concurrency();
+  const int maxThreads = CurrentContext().maxThreads;
+  if (maxThreads > 0) threads = std::min(threads, maxThreads);
+  return std::max(threads, 1);
+}
+
+/**
+ * The number of chunks to split n bytes or items into: one if autoPolicy()
+ * keeps a workload of this size sequential, otherwise about one per thread.
+ */
+int NumChunks(size_t n) {
+  if (autoPolicy(std::min<size_t>(n, std::numeric_limits<int>::max())) ==
+      ExecutionPolicy::Seq)
+    return 1;
+  return std::max<size_t>(1, std::min<size_t>(NumThreads(), n / kMinChunk));
+}
+
+/**
+ * Calls func(chunk) for chunk in [0, numChunks) on the parallel backend, so
+ * that they run on the threads of the current ExecutionContext, and rethrows
+ * the first exception any of them threw. The chunks are caller-owned memory,
+ * so this never runs on the GPU.
+ */
+template <typename Func>
+void ParallelChunks(int numChunks, Func func) {
+  if (numChunks == 1) {
+    func(0);
+    return;
+  }
+  std::vector<std::exception_ptr> errors(numChunks);
+  for_each_n(ExecutionPolicy::Par, countAt(0), numChunks, [&](int chunk) {
+    try {
+      func(chunk);
+    } catch (...) {
+      errors[chunk] = std::current_exception();
+    }
+  });
+  for (auto& error : errors)
+    if (error) std::rethrow_exception(error);
+}
+
+/**
+ * Calls func(begin, end) over chunks of [0, n) in parallel.
+ */
+template <typename Func>
+void ParallelFor(size_t n, Func func) {
+  const int numChunks = NumChunks(n);
+  ParallelChunks(numChunks, [&](int chunk) {
+    func(n * chunk / numChunks, n * (chunk + 1) / numChunks);
+  });
+}
+
+/**
+ * Splits text into numChunks ranges that each start at the beginning of a
+ * line.
+ */
+std::vector<const char*> LineChunks(const char* begin, const char* end,
+                                    int numChunks) {
+  std::vector<const char*> bounds(numChunks + 1, end);
+  bounds[0] = begin;
+  const size_t size = end - begin;
+  for (int i = 1; i < numChunks; ++i) {
+    const char* p = std::max(begin + size * i / numChunks, bounds[i - 1]);
+    p = std::find(p, end, '\n');
+    bounds[i] = p == end ? end : p + 1;
+  }
+  return bounds;
+}
+
+bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+void SkipSpace(const char*& p, const char* end) {
+  while (p < end && IsSpace(*p)) ++p;
+}
+
+const char* NextLine(const char* p, const char* end) {
+  p = std::find(p, end, '\n');
+  return p == end ? end : p + 1;
+}
+
+bool AtLineEnd(const char* p, const char* end) {
+  return p == end || *p == '\n';
+}
+
+void SkipToken(const char*& p, const char* end) {
+  SkipSpace(p, end);
+  while (p < end && !IsSpace(*p) && *p != '\n') ++p;
+}
+
+bool MatchToken(const char*& p, const char* end, const char* token) {
+  SkipSpace(p, end);
+  const size_t len = std::strlen(token);
+  if (static_cast<size_t>(end - p) < len || std::strncmp(p, token, len) != 0)
+    return false;
+  if (p + len < end && !IsSpace(p[len]) && p[len] != '\n') return false;
+  p += len;
+  return true;
+}
+
+/**
+ * Parses an integer at p, which need not be null-terminated, and advances p
+ * past it. Magnitudes beyond the range of int saturate at 2^32, which is out
+ * of range for every caller but cannot overflow.
+ */
+bool ParseInt(const char*& p, const char* end, int64_t& out) {
+  constexpr int64_t kSaturated = int64_t{1} << 32;
+  SkipSpace(p, end);
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+  if (p == end || *p < '0' || *p > '9') return false;
+  int64_t value = 0;
+  while (p < end && *p >= '0' && *p <= '9')
+    value = std::min(kSaturated, value * 10 + (*p++ - '0'));
+  out = negative ? -value : value;
+  return true;
+}
+
+/**
+ * Parses a decimal floating-point number at p, which need not be
+ * null-terminated, and advances p past it. Exact to within the precision of a
+ * float, which is all a Mesh keeps.
+ */
+bool ParseDouble(const char*& p, const char* end, double& out) {
+  SkipSpace(p, end);
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+  uint64_t mantissa = 0;
+  int exponent = 0;
+  int digits = 0;
+  bool any = false;
+  for (; p < end && *p >= '0' && *p <= '9'; ++p, any = true) {
+    if (digits < 19) {
+      mantissa = mantissa * 10 + (*p - '0');
+      if (mantissa > 0) ++digits;
+    } else {
+      ++exponent;
+    }
+  }
+  if (p < end && *p == '.') {
+    for (++p; p < end && *p >= '0' && *p <= '9'; ++p, any = true) {
+      if (digits < 19) {
+        mantissa = mantissa * 10 + (*p - '0');
+        if (mantissa > 0) ++digits;
+        --exponent;
+      }
+    }
+  }
+  if (!any) return false;
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    const char* q = p + 1;
+    int64_t e;
+    if (ParseInt(q, end, e)) {
+      exponent += std::max<int64_t>(std::min<int64_t>(e, 1000), -1000);
+      p = q;
+    }
+  }
+  double value = static_cast<double>(mantissa);
+  if (exponent < 0)
+    value /= std::pow(10.0, -exponent);
+  else if (exponent > 0)
+    value *= std::pow(10.0, exponent);
+  out = negative ? -value : value;
+  return true;
+}
+
+bool ParseVec3(const char*& p, const char* end, glm::vec3& v) {
+  double x, y, z;
+  if (!ParseDouble(p, end, x) || !ParseDouble(p, end, y) ||
+      !ParseDouble(p, end, z))
+    return false;
+  v = glm::vec3(x, y, z);
+  return true;
+}
+
+/**
+ * Triangulates a convex polygon as a fan, as Assimp does.
+ */
+void AddPolygon(std::vector<glm::ivec3>& tris, const int* verts, int n) {
+  for (int i = 2; i < n; ++i)
+    tris.emplace_back(verts[0], verts[i - 1], verts[i]);
+}
+
+/**
+ * Appends each chunk's triangles to triVerts in order.
+ */
+void Concatenate(std::vector<glm::ivec3>& triVerts,
+                 const std::vector<std::vector<glm::ivec3>>& chunks) {
+  size_t total = triVerts.size();
+  for (const auto& chunk : chunks) total += chunk.size();
+  triVerts.reserve(total);
+  for (const auto& chunk : chunks)
+    triVerts.insert(triVerts.end(), chunk.begin(), chunk.end());
+}
+
+template <typename T>
+T Load(const char* p, bool swap) {
+  char bytes[sizeof(T)];
+  std::memcpy(bytes, p, sizeof(T));
+  if (swap) std::reverse(bytes, bytes + sizeof(T));
+  T value;
+  std::memcpy(&value, bytes, sizeof(T));
+  return value;
+}
+
+// ---------------------------------------------------------------- STL
+
+constexpr size_t kStlHeader = 84;
+constexpr size_t kStlTriangle = 50;
+
+bool IsBinarySTL(const MappedFile& file) {
+  if (file.size() < kStlHeader) return false;
+  const uint32_t numTri = Load<uint32_t>(file.begin() + 80, false);
+  return file.size() == kStlHeader + kStlTriangle * numTri;
+}
+
+void ReadBinarySTL(const MappedFile& file, Mesh& mesh) {
+  const size_t numTri = Load<uint32_t>(file.begin() + 80, false);
+  mesh.vertPos.resize(3 * numTri);
+  mesh.triVerts.resize(numTri);
+  ParallelFor(numTri, [&](size_t begin, size_t end) {
+    for (size_t tri = begin; tri < end; ++tri) {
+      // Skip the facet normal, which is recomputed anyway.
+      const char* p = file.begin() + kStlHeader + kStlTriangle * tri + 12;
+      for (int i : {0, 1, 2}) {
+        glm::vec3& v = mesh.vertPos[3 * tri + i];
+        for (int j : {0, 1, 2})
+          v[j] = Load<float>(p + 4 * (3 * i + j), false);
+      }
+      const int first = 3 * tri;
+      mesh.triVerts[tri] = glm::ivec3(first, first + 1, first + 2);
+    }
+  });
+}
+
+void ReadAsciiSTL(const MappedFile& file, Mesh& mesh) {
+  const int numChunks = NumChunks(file.size());
+  const std::vector<const char*> bounds =
+      LineChunks(file.begin(), file.end(), numChunks);
+  std::vector<size_t> offset(numChunks + 1, 0);
+  ParallelChunks(numChunks, [&](int chunk) {
+    size_t count = 0;
+    for (const char* p = bounds[chunk]; p < bounds[chunk + 1];
+         p = NextLine(p, bounds[chunk + 1])) {
+      if (MatchToken(p, bounds[chunk + 1], "vertex")) ++count;
+    }
+    offset[chunk + 1] = count;
+  });
+  std::partial_sum(offset.begin(), offset.end(), offset.begin());
+  const size_t numVert = offset.back();
+  ALWAYS_ASSERT(numVert % 3 == 0, userErr,
+                "STL vertices do not form whole triangles.");
+
+  mesh.vertPos.resize(numVert);
+  ParallelChunks(numChunks, [&](int chunk) {
+    const char* end = bounds[chunk + 1];
+    size_t vert = offset[chunk];
+    for (const char* p = bounds[chunk]; p < end; p = NextLine(p, end)) {
+      if (!MatchToken(p, end, "vertex")) continue;
+      ALWAYS_ASSERT(ParseVec3(p, end, mesh.vertPos[vert++]), userErr,
+                    "Invalid STL vertex.");
+    }
+  });
+  mesh.triVerts.resize(numVert / 3);
+  for (int tri = 0; tri < mesh.triVerts.size(); ++tri)
+    mesh.triVerts[tri] = glm::ivec3(3 * tri, 3 * tri + 1, 3 * tri + 2);
+}
+
+// ---------------------------------------------------------------- PLY
+
+enum class PlyType { Int8, UInt8, Int16, UInt16, Int32, UInt32, Float, Double };
+
+bool ParsePlyType(const std::string& name, PlyType& type) {
+  static const std::pair<const char*, PlyType> types[] = {
+      {"char", PlyType::Int8},      {"int8", PlyType::Int8},
+      {"uchar", PlyType::UInt8},    {"uint8", PlyType::UInt8},
+      {"short", PlyType::Int16},    {"int16", PlyType::Int16},
+      {"ushort", PlyType::UInt16},  {"uint16", PlyType::UInt16},
+      {"int", PlyType::Int32},      {"int32", PlyType::Int32},
+      {"uint", PlyType::UInt32},    {"uint32", PlyType::UInt32},
+      {"float", PlyType::Float},    {"float32", PlyType::Float},
+      {"double", PlyType::Double},  {"float64", PlyType::Double}};
+  for (const auto& t : types) {
+    if (name == t.first) {
+      type = t.second;
+      return true;
+    }
+  }
+  return false;
+}
+
+int PlySize(PlyType type) {
+  switch (type) {
+    case PlyType::Int8:
+    case PlyType::UInt8:
+      return 1;
+    case PlyType::Int16:
+    case PlyType::UInt16:
+      return 2;
+    case PlyType::Int32:
+    case PlyType::UInt32:
+    case PlyType::Float:
+      return 4;
+    case PlyType::Double:
+      return 8;
+  }
+  return 0;
+}
+
+double LoadPly(const char* p, PlyType type, bool swap) {
+  switch (type) {
+    case PlyType::Int8:
+      return Load<int8_t>(p, swap);
+    case PlyType::UInt8:
+      return Load<uint8_t>(p, swap);
+    case PlyType::Int16:
+      return Load<int16_t>(p, swap);
+    case PlyType::UInt16:
+      return Load<uint16_t>(p, swap);
+    case PlyType::Int32:
+      return Load<int32_t>(p, swap);
+    case PlyType::UInt32:
+      return Load<uint32_t>(p, swap);
+    case PlyType::Float:
+      return Load<float>(p, swap);
+    case PlyType::Double:
+      return Load<double>(p, swap);
+  }
+  return 0;
+}
+
+struct PlyProperty {
+  std::string name;
+  PlyType type;
+  bool isList = false;
+  PlyType countType;
+};
+
+struct PlyElement {
+  std::string name;
+  size_t count = 0;
+  std::vector<PlyProperty> properties;
+
+  bool HasList() const {
+    return std::any_of(properties.begin(), properties.end(),
+                       [](const PlyProperty& p) { return p.isList; });
+  }
+  int Stride() const {
+    int stride = 0;
+    for (const auto& p : properties) stride += PlySize(p.type);
+    return stride;
+  }
+};
+
+enum class PlyFormat { Ascii, BinaryLE, BinaryBE };
+
+struct PlyHeader {
+  PlyFormat format;
+  std::vector<PlyElement> elements;
+  const char* body;
+};
+
+std::string NextWord(const char*& p, const char* end) {
+  SkipSpace(p, end);
+  const char* start = p;
+  SkipToken(p, end);
+  return std::string(start, p);
+}
+
+bool ParsePlyHeader(const MappedFile& file, PlyHeader& header) {
+  const char* p = file.begin();
+  const char* end = file.end();
+  if (NextWord(p, end) != "ply") return false;
+  bool hasFormat = false;
+  for (p = NextLine(p, end); p < end; p = NextLine(p, end)) {
+    const char* line = p;
+    const std::string keyword = NextWord(line, end);
+    if (keyword == "format") {
+      const std::string format = NextWord(line, end);
+      if (format == "ascii")
+        header.format = PlyFormat::Ascii;
+      else if (format == "binary_little_endian")
+        header.format = PlyFormat::BinaryLE;
+      else if (format == "binary_big_endian")
+        header.format = PlyFormat::BinaryBE;
+      else
+        return false;
+      hasFormat = true;
+    } else if (keyword == "element") {
+      PlyElement element;
+      element.name = NextWord(line, end);
+      int64_t count;
+      if (!ParseInt(line, end, count) || count < 0) return false;
+      element.count = count;
+      header.elements.push_back(element);
+    } else if (keyword == "property") {
+      if (header.elements.empty()) return false;
+      PlyProperty property;
+      std::string type = NextWord(line, end);
+      if (type == "list") {
+        property.isList = true;
+        if (!ParsePlyType(NextWord(line, end), property.countType))
+          return false;
+        type = NextWord(line, end);
+      }
+      if (!ParsePlyType(type, property.type)) return false;
+      property.name = NextWord(line, end);
+      header.elements.back().properties.push_back(property);
+    } else if (keyword == "end_header") {
+      header.body = NextLine(p, end);
+      return hasFormat;
+    }
+  }
+  return false;
+}
+
+/**
+ * The positions of x, y and z among the vertex element's properties.
+ */
+bool FindPlyPosition(const PlyElement& vertex, int xyz[3]) {
+  const char* names[3] = {"x", "y", "z"};
+  for (int j : {0, 1, 2}) {
+    xyz[j] = -1;
+    for (int i = 0; i < vertex.properties.size(); ++i) {
+      if (vertex.properties[i].name == names[j] &&
+          !vertex.properties[i].isList)
+        xyz[j] = i;
+    }
+    if (xyz[j] < 0) return false;
+  }
+  return true;
+}
+
+int FindPlyIndices(const PlyElement& face) {
+  for (int i = 0; i < face.properties.size(); ++i) {
+    const PlyProperty& p = face.properties[i];
+    if (p.isList && (p.name == "vertex_indices" || p.name == "vertex_index"))
+      return i;
+  }
+  return -1;
+}
+
+bool ReadBinaryPLY(const MappedFile& file, const PlyHeader& header,
+                   Mesh& mesh) {
+  const bool swap = header.format == PlyFormat::BinaryBE;
+  const char* p = header.body;
+  for (const PlyElement& element : header.elements) {
+    if (element.name == "vertex") {
+      int xyz[3];
+      if (element.HasList() || !FindPlyPosition(element, xyz)) return false;
+      const size_t stride = element.Stride();
+      ALWAYS_ASSERT(stride * element.count <= file.end() - p, userErr,
+                    "PLY file is truncated.");
+      int offset[3];
+      for (int j : {0, 1, 2}) {
+        offset[j] = 0;
+        for (int i = 0; i < xyz[j]; ++i)
+          offset[j] += PlySize(element.properties[i].type);
+      }
+      mesh.vertPos.resize(element.count);
+      ParallelFor(element.count, [&](size_t begin, size_t end) {
+        for (size_t vert = begin; vert < end; ++vert) {
+          const char* record = p + stride * vert;
+          for (int j : {0, 1, 2})
+            mesh.vertPos[vert][j] = LoadPly(
+                record + offset[j], element.properties[xyz[j]].type, swap);
+        }
+      });
+      p += stride * element.count;
+    } else if (element.name == "face") {
+      const int indices = FindPlyIndices(element);
+      if (indices < 0) return false;
+      // Lists make records variable in size, but when every face is a
+      // triangle they are fixed and can be decoded in parallel.
+      int before = 0;
+      size_t stride = 0;
+      bool fixed = true;
+      for (int i = 0; i < element.properties.size(); ++i) {
+        const PlyProperty& prop = element.properties[i];
+        if (prop.isList && i != indices) fixed = false;
+        const int size = prop.isList
+                             ? PlySize(prop.countType) + 3 * PlySize(prop.type)
+                             : PlySize(prop.type);
+        if (i < indices) before += size;
+        stride += size;
+      }
+      const PlyProperty& list = element.properties[indices];
+      if (stride * element.count > static_cast<size_t>(file.end() - p))
+        fixed = false;
+      if (fixed) {
+        std::vector<char> triangles(NumChunks(element.count), true);
+        const int numChunks = triangles.size();
+        ParallelChunks(numChunks, [&](int chunk) {
+          const size_t begin = element.count * chunk / numChunks;
+          const size_t end = element.count * (chunk + 1) / numChunks;
+          for (size_t face = begin; face < end; ++face) {
+            if (LoadPly(p + stride * face + before, list.countType, swap) != 3)
+              triangles[chunk] = false;
+          }
+        });
+        fixed = std::all_of(triangles.begin(), triangles.end(),
+                            [](char t) { return t; });
+      }
+      if (fixed) {
+        const int countSize = PlySize(list.countType);
+        const int indexSize = PlySize(list.type);
+        mesh.triVerts.resize(element.count);
+        ParallelFor(element.count, [&](size_t begin, size_t end) {
+          for (size_t face = begin; face < end; ++face) {
+            const char* record = p + stride * face + before + countSize;
+            for (int j : {0, 1, 2})
+              mesh.triVerts[face][j] =
+                  LoadPly(record + indexSize * j, list.type, swap);
+          }
+        });
+        p += stride * element.count;
+      } else {
+        std::vector<int> polygon;
+        for (size_t face = 0; face < element.count; ++face) {
+          for (int i = 0; i < element.properties.size(); ++i) {
+            const PlyProperty& prop = element.properties[i];
+            const int size = PlySize(prop.type);
+            int n = 1;
+            if (prop.isList) {
+              ALWAYS_ASSERT(PlySize(prop.countType) <= file.end() - p, userErr,
+                            "PLY file is truncated.");
+              n = LoadPly(p, prop.countType, swap);
+              p += PlySize(prop.countType);
+            }
+            ALWAYS_ASSERT(size * n <= file.end() - p, userErr,
+                          "PLY file is truncated.");
+            if (i == indices) {
+              polygon.resize(n);
+              for (int j = 0; j < n; ++j)
+                polygon[j] = LoadPly(p + size * j, prop.type, swap);
+              AddPolygon(mesh.triVerts, polygon.data(), n);
+            }
+            p += size * n;
+          }
+        }
+      }
+    } else {
+      // Other elements are skipped, which requires them to be fixed-size.
+      if (element.HasList()) return false;
+      p += element.Stride() * element.count;
+    }
+  }
+  return true;
+}
+
+bool ReadAsciiPLY(const MappedFile& file, const PlyHeader& header,
+                  Mesh& mesh) {
+  // Each element's records are the next count non-empty lines.
+  std::vector<size_t> first = {0};
+  int vertexElement = -1, faceElement = -1;
+  int xyz[3];
+  int indices = -1;
+  for (int i = 0; i < header.elements.size(); ++i) {
+    const PlyElement& element = header.elements[i];
+    first.push_back(first.back() + element.count);
+    if (element.name == "vertex") {
+      if (element.HasList() || !FindPlyPosition(element, xyz)) return false;
+      vertexElement = i;
+    } else if (element.name == "face") {
+      indices = FindPlyIndices(element);
+      if (indices < 0) return false;
+      faceElement = i;
+    }
+  }
+
+  const int numChunks = NumChunks(file.end() - header.body);
+  const std::vector<const char*> bounds =
+      LineChunks(header.body, file.end(), numChunks);
+  std::vector<size_t> offset(numChunks + 1, 0);
+  ParallelChunks(numChunks, [&](int chunk) {
+    size_t count = 0;
+    for (const char* p = bounds[chunk]; p < bounds[chunk + 1];
+         p = NextLine(p, bounds[chunk + 1])) {
+      const char* q = p;
+      SkipSpace(q, bounds[chunk + 1]);
+      if (!AtLineEnd(q, bounds[chunk + 1])) ++count;
+    }
+    offset[chunk + 1] = count;
+  });
+  std::partial_sum(offset.begin(), offset.end(), offset.begin());
+  ALWAYS_ASSERT(offset.back() >= first.back(), userErr,
+                "PLY file is truncated.");
+
+  if (vertexElement >= 0)
+    mesh.vertPos.resize(header.elements[vertexElement].count);
+  std::vector<std::vector<glm::ivec3>> tris(numChunks);
+  ParallelChunks(numChunks, [&](int chunk) {
+    const char* end = bounds[chunk + 1];
+    size_t record = offset[chunk];
+    std::vector<int> polygon;
+    std::vector<double> values;
+    for (const char* p = bounds[chunk]; p < end; p = NextLine(p, end)) {
+      SkipSpace(p, end);
+      if (AtLineEnd(p, end)) continue;
+      const int e =
+          std::upper_bound(first.begin(), first.end(), record) - first.begin() -
+          1;
+      const size_t index = record++ - first[e];
+      if (e != vertexElement && e != faceElement) continue;
+      const PlyElement& element = header.elements[e];
+      values.clear();
+      for (int i = 0; i < element.properties.size(); ++i) {
+        int64_t n = 1;
+        if (element.properties[i].isList)
+          ALWAYS_ASSERT(ParseInt(p, end, n) && n >= 0, userErr,
+                        "Invalid PLY list.");
+        if (i == indices && e == faceElement) polygon.resize(n);
+        for (int j = 0; j < n; ++j) {
+          double value;
+          ALWAYS_ASSERT(ParseDouble(p, end, value), userErr,
+                        "Invalid PLY value.");
+          if (e == vertexElement) values.push_back(value);
+          if (e == faceElement && i == indices) polygon[j] = value;
+        }
+      }
+      if (e == vertexElement) {
+        for (int j : {0, 1, 2}) mesh.vertPos[index][j] = values[xyz[j]];
+      } else {
+        AddPolygon(tris[chunk], polygon.data(), polygon.size());
+      }
+    }
+  });
+  Concatenate(mesh.triVerts, tris);
+  return true;
+}
+
+bool ReadPLY(const MappedFile& file, Mesh& mesh) {
+  PlyHeader header;
+  if (!ParsePlyHeader(file, header)) return false;
+  if (header.format == PlyFormat::Ascii)
+    return ReadAsciiPLY(file, header, mesh);
+  return ReadBinaryPLY(file, header, mesh);
+}
+
+// ---------------------------------------------------------------- OBJ
+
+/**
+ * Parses the vertex of an OBJ face ("v", "v/vt", "v//vn" or "v/vt/vn") as a
+ * zero-based index. Negative indices count back from the numVert vertices
+ * defined so far. Fails if the index does not fit in an int; whether it names
+ * a vertex is checked once all are known.
+ */
+bool ParseObjIndex(const char*& p, const char* end, int64_t numVert,
+                   int& out) {
+  int64_t index;
+  if (!ParseInt(p, end, index) || index == 0) return false;
+  while (p < end && !IsSpace(*p) && *p != '\n') ++p;
+  index = index < 0 ? numVert + index : index - 1;
+  if (index < 0 || index > std::numeric_limits<int>::max()) return false;
+  out = index;
+  return true;
+}
+
+void ReadOBJ(const MappedFile& file, Mesh& mesh) {
+  const int numChunks = NumChunks(file.size());
+  const std::vector<const char*> bounds =
+      LineChunks(file.begin(), file.end(), numChunks);
+  // Vertices are counted first so that relative face indices can be resolved
+  // in each chunk.
+  std::vector<size_t> offset(numChunks + 1, 0);
+  ParallelChunks(numChunks, [&](int chunk) {
+    size_t count = 0;
+    for (const char* p = bounds[chunk]; p < bounds[chunk + 1];
+         p = NextLine(p, bounds[chunk + 1])) {
+      if (MatchToken(p, bounds[chunk + 1], "v")) ++count;
+    }
+    offset[chunk + 1] = count;
+  });
+  std::partial_sum(offset.begin(), offset.end(), offset.begin());
+
+  mesh.vertPos.resize(offset.back());
+  std::vector<std::vector<glm::ivec3>> tris(numChunks);
+  ParallelChunks(numChunks, [&](int chunk) {
+    const char* end = bounds[chunk + 1];
+    size_t vert = offset[chunk];
+    std::vector<int> polygon;
+    for (const char* p = bounds[chunk]; p < end; p = NextLine(p, end)) {
+      if (MatchToken(p, end, "v")) {
+        ALWAYS_ASSERT(ParseVec3(p, end, mesh.vertPos[vert++]), userErr,
+                      "Invalid OBJ vertex.");
+      } else if (MatchToken(p, end, "f")) {
+        polygon.clear();
+        for (SkipSpace(p, end); !AtLineEnd(p, end); SkipSpace(p, end)) {
+          int index;
+          ALWAYS_ASSERT(ParseObjIndex(p, end, vert, index), userErr,
+                        "Invalid OBJ face.");
+          polygon.push_back(index);
+        }
+        AddPolygon(tris[chunk], polygon.data(), polygon.size());
+      }
+    }
+  });
+  Concatenate(mesh.triVerts, tris);
+}
+// ---------------------------------------------------------------- Writers
+
+// Vertices or triangles extracted and encoded at a time, which bounds the
+// memory of an export.
+constexpr int kExportChunk = 1 << 18;
+
+/**
+ * Calls func(first, n) for consecutive chunks of [0, total).
+ */
+template <typename Func>
+void ForEachChunk(int total, Func func) {
+  for (int first = 0; first < total; first += kExportChunk)
+    func(first, std::min(kExportChunk, total - first));
+}
+
+template <typename T>
+void Put(char*& p, T value) {
+  std::memcpy(p, &value, sizeof(T));
+  p += sizeof(T);
+}
+
+std::ofstream OpenOutput(const std::string& filename) {
+  std::ofstream out(filename, std::ios::binary);
+  ALWAYS_ASSERT(out.is_open(), userErr, "Cannot open file " + filename);
+  return out;
+}
+
+void CheckOutput(const std::ofstream& out, const std::string& filename) {
+  ALWAYS_ASSERT(out.good(), userErr, "Failed to write " + filename);
+}
+
+/**
+ * Extracts the vertex positions, and optionally normals, of a chunk into
+ * records of stride bytes.
+ */
+void GetVerts(const Manifold& manifold, int first, int n, char* records,
+              int stride, bool normals) {
+  MeshBuffers buffers;
+  buffers.vertPos = records;
+  buffers.vertStride = stride;
+  if (normals) {
+    buffers.vertNormal = records + 12;
+    buffers.normalStride = stride;
+  }
+  buffers.firstVert = first;
+  buffers.numVert = n;
+  buffers.numTri = 0;
+  manifold.GetMesh(buffers);
+}
+
+void GetTris(const Manifold& manifold, int first, int n,
+             std::vector<uint32_t>& tris) {
+  tris.resize(3 * n);
+  MeshBuffers buffers;
+  buffers.triVerts = tris.data();
+  buffers.numVert = 0;
+  buffers.firstTri = first;
+  buffers.numTri = n;
+  manifold.GetMesh(buffers);
+}
+
+void WriteSTL(const std::string& filename, const Manifold& manifold) {
+  const int numVert = manifold.NumVert();
+  const int numTri = manifold.NumTri();
+  // Every triangle repeats its vertices, so they are extracted once.
+  std::vector<glm::vec3> vertPos(numVert);
+  GetVerts(manifold, 0, numVert, reinterpret_cast<char*>(vertPos.data()), 12,
+           false);
+
+  std::ofstream out = OpenOutput(filename);
+  std::string header = "Binary STL written by manifold";
+  header.resize(80, ' ');
+  out.write(header.data(), header.size());
+  const uint32_t count = numTri;
+  out.write(reinterpret_cast<const char*>(&count), 4);
+
+  std::vector<uint32_t> tris;
+  std::vector<char> records;
+  ForEachChunk(numTri, [&](int first, int n) {
+    GetTris(manifold, first, n, tris);
+    records.resize(kStlTriangle * n);
+    ParallelFor(n, [&](size_t begin, size_t end) {
+      for (size_t tri = begin; tri < end; ++tri) {
+        const glm::vec3 v0 = vertPos[tris[3 * tri]];
+        const glm::vec3 v1 = vertPos[tris[3 * tri + 1]];
+        const glm::vec3 v2 = vertPos[tris[3 * tri + 2]];
+        glm::vec3 normal = glm::cross(v1 - v0, v2 - v0);
+        const float length = glm::length(normal);
+        normal = length > 0 ? normal / length : glm::vec3(0);
+        char* p = records.data() + kStlTriangle * tri;
+        for (const glm::vec3& v : {normal, v0, v1, v2})
+          for (int j : {0, 1, 2}) Put(p, v[j]);
+        Put<uint16_t>(p, 0);
+      }
+    });
+    out.write(records.data(), records.size());
+  });
+  CheckOutput(out, filename);
+}
+
+void WritePLY(const std::string& filename, const Manifold& manifold,
+              const ExportOptions& options) {
+  const int numVert = manifold.NumVert();
+  const int numTri = manifold.NumTri();
+  const bool normals = !options.faceted;
+  const std::vector<glm::vec4>& colors = options.mat.vertColor;
+  ALWAYS_ASSERT(colors.empty() || colors.size() == numVert, userErr,
+                "If present, vertColor must be the same length as vertPos.");
+
+  std::ofstream out = OpenOutput(filename);
+  out << "ply\nformat binary_little_endian 1.0\n"
+      << "comment Created by manifold\n"
+      << "element vertex " << numVert << "\n"
+      << "property float x\nproperty float y\nproperty float z\n";
+  if (normals)
+    out << "property float nx\nproperty float ny\nproperty float nz\n";
+  if (!colors.empty())
+    out << "property uchar red\nproperty uchar green\nproperty uchar blue\n"
+        << "property uchar alpha\n";
+  out << "element face " << numTri << "\n"
+      << "property list uchar int vertex_indices\nend_header\n";
+
+  const int colorOffset = normals ? 24 : 12;
+  const int stride = colorOffset + (colors.empty() ? 0 : 4);
+  std::vector<char> records;
+  ForEachChunk(numVert, [&](int first, int n) {
+    records.resize(static_cast<size_t>(stride) * n);
+    GetVerts(manifold, first, n, records.data(), stride, normals);
+    if (!colors.empty()) {
+      ParallelFor(n, [&](size_t begin, size_t end) {
+        for (size_t vert = begin; vert < end; ++vert) {
+          char* p = records.data() + stride * vert + colorOffset;
+          const glm::vec4 c = glm::clamp(colors[first + vert], 0.0f, 1.0f);
+          for (int j : {0, 1, 2, 3})
+            Put<uint8_t>(p, std::lround(255 * c[j]));
+        }
+      });
+    }
+    out.write(records.data(), records.size());
+  });
+
+  constexpr int kFace = 13;
+  std::vector<uint32_t> tris;
+  ForEachChunk(numTri, [&](int first, int n) {
+    GetTris(manifold, first, n, tris);
+    records.resize(kFace * n);
+    ParallelFor(n, [&](size_t begin, size_t end) {
+      for (size_t tri = begin; tri < end; ++tri) {
+        char* p = records.data() + kFace * tri;
+        Put<uint8_t>(p, 3);
+        for (int j : {0, 1, 2}) Put<int32_t>(p, tris[3 * tri + j]);
+      }
+    });
+    out.write(records.data(), records.size());
+  });
+  CheckOutput(out, filename);
+}
+
+/**
+ * glTF is Y-up, while Manifold is Z-up.
+ */
+void ToYup(char* records, int stride, int offset, int n) {
+  ParallelFor(n, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      float* v = reinterpret_cast<float*>(records + stride * i + offset);
+      const glm::vec3 zUp(v[0], v[1], v[2]);
+      v[0] = zUp.y;
+      v[1] = zUp.z;
+      v[2] = zUp.x;
+    }
+  });
+}
+
+std::string JsonFloat(float value) {
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+  return buffer;
+}
+
+uint8_t ZigZag8(uint8_t v) {
+  return static_cast<uint8_t>((v & 0x80 ? 0xFF : 0) ^ (v << 1));
+}
+
+/**
+ * Appends a group of 16 bytes packed into bits each, with values that do not
+ * fit escaped after the group, as in meshoptimizer's vertex codec.
+ */
+void EncodeByteGroup(const uint8_t* group, int bits, std::string& out) {
+  if (bits == 0) return;
+  if (bits == 8) {
+    out.append(reinterpret_cast<const char*>(group), 16);
+    return;
+  }
+  const int sentinel = (1 << bits) - 1;
+  for (int i = 0; i < 16; i += 8 / bits) {
+    int byte = 0;
+    for (int j = 0; j < 8 / bits; ++j)
+      byte = byte << bits | std::min<int>(group[i + j], sentinel);
+    out.push_back(byte);
+  }
+  for (int i = 0; i < 16; ++i)
+    if (group[i] >= sentinel) out.push_back(group[i]);
+}
+
+int ByteGroupSize(const uint8_t* group, int bits) {
+  if (bits == 8) return 16;
+  const int sentinel = (1 << bits) - 1;
+  int size = 2 * bits;
+  for (int i = 0; i < 16; ++i) size += group[i] >= sentinel;
+  return size;
+}
+
+/**
+ * Appends size (a multiple of 16) bytes in groups of 16, each in the fewest
+ * bits, after a header of two bits per group giving their widths.
+ */
+void EncodeBytes(const uint8_t* bytes, int size, std::string& out) {
+  const int numGroups = size / 16;
+  const size_t header = out.size();
+  out.append((numGroups + 3) / 4, 0);
+  for (int g = 0; g < numGroups; ++g) {
+    const uint8_t* group = bytes + 16 * g;
+    int mode = 0;
+    if (std::any_of(group, group + 16, [](uint8_t b) { return b != 0; })) {
+      mode = 1;
+      for (int m : {2, 3})
+        if (ByteGroupSize(group, 1 << m) < ByteGroupSize(group, 1 << mode))
+          mode = m;
+    }
+    out[header + g / 4] |= mode << (g % 4 * 2);
+    EncodeByteGroup(group, mode == 0 ? 0 : 1 << mode, out);
+  }
+}
+
+/**
+ * Encodes a block of up to 256 elements in meshoptimizer's vertex codec: each
+ * byte of the elements is delta-encoded from the same byte of the previous
+ * element, starting from last, and the zigzagged deltas are packed.
+ */
+std::string EncodeVertexBlock(const uint8_t* data, int n, int stride,
+                              const uint8_t* last) {
+  std::string out;
+  uint8_t deltas[256];
+  const int aligned = (n + 15) & ~15;
+  std::fill(deltas, deltas + aligned, 0);
+  for (int k = 0; k < stride; ++k) {
+    uint8_t previous = last[k];
+    for (int i = 0; i < n; ++i) {
+      const uint8_t value = data[stride * i + k];
+      deltas[i] = ZigZag8(value - previous);
+      previous = value;
+    }
+    EncodeBytes(deltas, aligned, out);
+  }
+  return out;
+}
+
+// Elements per block, which is the codec's maximum for strides up to 32
+// bytes, and blocks per thread.
+constexpr int kMeshoptBlock = 256;
+constexpr int kMinBlocks = 64;
+
+/**
+ * Encodes an attribute stream in meshoptimizer's vertex codec (mode
+ * ATTRIBUTES of EXT_meshopt_compression) a chunk at a time, with the blocks
+ * of a chunk encoded in parallel.
+ */
+class VertexEncoder {
+ public:
+  explicit VertexEncoder(int stride) : stride_(stride), last_(stride) {
+    out_.push_back(static_cast<char>(0xA0));
+  }
+
+  void Add(const char* data, int n) {
+    if (n == 0) return;
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+    if (first_.empty()) {
+      first_.assign(bytes, bytes + stride_);
+      last_ = first_;
+    }
+    const int numBlocks = (n + kMeshoptBlock - 1) / kMeshoptBlock;
+    std::vector<std::string> blocks(numBlocks);
+    const int numChunks =
+        std::max(1, std::min(NumThreads(), numBlocks / kMinBlocks));
+    ParallelChunks(numChunks, [&](int chunk) {
+      const int end = numBlocks * (chunk + 1) / numChunks;
+      for (int b = numBlocks * chunk / numChunks; b < end; ++b) {
+        const uint8_t* block = bytes + stride_ * kMeshoptBlock * b;
+        blocks[b] = EncodeVertexBlock(
+            block, std::min<int>(kMeshoptBlock, n - kMeshoptBlock * b),
+            stride_, b == 0 ? last_.data() : block - stride_);
+      }
+    });
+    for (const std::string& block : blocks) out_ += block;
+    last_.assign(bytes + stride_ * (n - 1), bytes + stride_ * n);
+  }
+
+  std::string Finish() {
+    // The tail holds the baseline of the first block, padded to 32 bytes.
+    if (stride_ < 32) out_.append(32 - stride_, 0);
+    first_.resize(stride_);
+    out_.append(first_.begin(), first_.end());
+    return std::move(out_);
+  }
+
+ private:
+  const int stride_;
+  std::vector<uint8_t> first_, last_;
+  std::string out_;
+};
+
+/**
+ * Encodes indices in meshoptimizer's index sequence codec (mode INDICES of
+ * EXT_meshopt_compression): zigzagged deltas from one of two baselines, as
+ * variable-length integers.
+ */
+class IndexEncoder {
+ public:
+  IndexEncoder() { out_.push_back(static_cast<char>(0xD1)); }
+
+  void Add(const uint32_t* indices, int n) {
+    for (int i = 0; i < n; ++i) {
+      const uint32_t index = indices[i];
+      const int32_t delta = index - last_[current_];
+      // Switch baselines when the delta no longer fits in a byte.
+      current_ ^= (delta < 0 ? -delta : delta) >= 30;
+      const uint32_t d = index - last_[current_];
+      const uint32_t v = (d << 1) ^ static_cast<uint32_t>(
+                                        static_cast<int32_t>(d) >> 31);
+      uint32_t code = v << 1 | current_;
+      do {
+        out_.push_back((code & 127) | (code > 127 ? 128 : 0));
+        code >>= 7;
+      } while (code != 0);
+      last_[current_] = index;
+    }
+  }
+
+  std::string Finish() {
+    out_.append(4, 0);
+    return std::move(out_);
+  }
+
+ private:
+  uint32_t last_[2] = {0, 0};
+  int current_ = 0;
+  std::string out_;
+};
+
+int8_t QuantizeSnorm(float value) {
+  return std::lround(127 * glm::clamp(value, -1.0f, 1.0f));
+}
+
+/**
+ * One accessor of the GLB and its bufferView, filled a chunk at a time.
+ */
+struct GlbStream {
+  const char* attribute;  // nullptr for the indices
+  int componentType;
+  const char* type;
+  bool normalized;
+  int count;
+  int stride;
+  int target;
+  std::string bounds;
+  const char* filter;  // nullptr for none
+  std::function<void(int first, int n, char* out)> fill;
+};
+
+constexpr int kFloat = 5126;
+constexpr int kByte = 5120;
+constexpr int kUnsignedByte = 5121;
+constexpr int kShort = 5122;
+constexpr int kUnsignedShort = 5123;
+constexpr int kUnsignedInt = 5125;
+constexpr int kArrayBuffer = 34962;
+constexpr int kElementArrayBuffer = 34963;
+
+std::string JsonVec3(glm::vec3 v) {
+  return "[" + JsonFloat(v.x) + "," + JsonFloat(v.y) + "," + JsonFloat(v.z) +
+         "]";
+}
+
+void WriteGLB(const std::string& filename, const Manifold& manifold,
+              const ExportOptions& options) {
+  const int numVert = manifold.NumVert();
+  const int numTri = manifold.NumTri();
+  const bool quantize = options.quantize;
+  const bool compress = options.compress;
+  const std::vector<glm::vec4>& colors = options.mat.vertColor;
+  ALWAYS_ASSERT(colors.empty() || colors.size() == numVert, userErr,
+                "If present, vertColor must be the same length as vertPos.");
+
+  // The accessor bounds precede the binary data, so they take a first pass.
+  glm::vec3 min(std::numeric_limits<float>::infinity());
+  glm::vec3 max(-std::numeric_limits<float>::infinity());
+  std::vector<char> records;
+  ForEachChunk(numVert, [&](int first, int n) {
+    records.resize(12 * n);
+    GetVerts(manifold, first, n, records.data(), 12, false);
+    ToYup(records.data(), 12, 0, n);
+    const glm::vec3* pos = reinterpret_cast<const glm::vec3*>(records.data());
+    for (int i = 0; i < n; ++i) {
+      min = glm::min(min, pos[i]);
+      max = glm::max(max, pos[i]);
+    }
+  });
+
+  // Quantized positions are offsets from the center in units of scale, which
+  // the node's transform undoes.
+  const glm::vec3 center = 0.5f * (min + max);
+  const glm::vec3 halfSize = 0.5f * (max - min);
+  float scale = glm::max(halfSize.x, glm::max(halfSize.y, halfSize.z)) / 32767;
+  if (scale == 0) scale = 1;
+
+  std::vector<GlbStream> streams;
+  std::vector<float> floats;
+  if (quantize) {
+    auto toShort = [&](glm::vec3 v) {
+      return glm::vec3(glm::round((v - center) / scale));
+    };
+    streams.push_back(
+        {"POSITION", kShort, "VEC3", false, numVert, 8, kArrayBuffer,
+         "\"min\":" + JsonVec3(toShort(min)) + ",\"max\":" +
+             JsonVec3(toShort(max)),
+         nullptr, [&](int first, int n, char* out) {
+           floats.resize(3 * n);
+           char* pos = reinterpret_cast<char*>(floats.data());
+           GetVerts(manifold, first, n, pos, 12, false);
+           ToYup(pos, 12, 0, n);
+           ParallelFor(n, [&](size_t begin, size_t end) {
+             for (size_t i = begin; i < end; ++i) {
+               char* p = out + 8 * i;
+               for (int j : {0, 1, 2})
+                 Put<int16_t>(p, std::lround((floats[3 * i + j] - center[j]) /
+                                             scale));
+               Put<int16_t>(p, 0);
+             }
+           });
+         }});
+  } else {
+    streams.push_back({"POSITION", kFloat, "VEC3", false, numVert, 12,
+                       kArrayBuffer,
+                       "\"min\":" + JsonVec3(min) + ",\"max\":" + JsonVec3(max),
+                       nullptr, [&](int first, int n, char* out) {
+                         GetVerts(manifold, first, n, out, 12, false);
+                         ToYup(out, 12, 0, n);
+                       }});
+  }
+
+  auto getNormals = [&](int first, int n, char* out) {
+    MeshBuffers buffers;
+    buffers.vertNormal = out;
+    buffers.firstVert = first;
+    buffers.numVert = n;
+    buffers.numTri = 0;
+    manifold.GetMesh(buffers);
+    ToYup(out, 12, 0, n);
+  };
+  if (!options.faceted && quantize) {
+    // Compressed normals are octahedral, which the decoder's filter turns
+    // back into normalized bytes.
+    streams.push_back(
+        {"NORMAL", kByte, "VEC3", true, numVert, 4, kArrayBuffer, "",
+         compress ? "OCTAHEDRAL" : nullptr, [&](int first, int n, char* out) {
+           floats.resize(3 * n);
+           getNormals(first, n, reinterpret_cast<char*>(floats.data()));
+           ParallelFor(n, [&](size_t begin, size_t end) {
+             for (size_t i = begin; i < end; ++i) {
+               glm::vec3 normal(floats[3 * i], floats[3 * i + 1],
+                                floats[3 * i + 2]);
+               int8_t* p = reinterpret_cast<int8_t*>(out + 4 * i);
+               if (compress) {
+                 const float l1 = glm::abs(normal.x) + glm::abs(normal.y) +
+                                  glm::abs(normal.z);
+                 normal /= l1 > 0 ? l1 : 1;
+                 if (normal.z < 0) {
+                   const glm::vec2 xy(normal.x, normal.y);
+                   normal.x = (1 - glm::abs(xy.y)) * (xy.x >= 0 ? 1 : -1);
+                   normal.y = (1 - glm::abs(xy.x)) * (xy.y >= 0 ? 1 : -1);
+                 }
+                 p[0] = QuantizeSnorm(normal.x);
+                 p[1] = QuantizeSnorm(normal.y);
+                 p[2] = 127;
+               } else {
+                 for (int j : {0, 1, 2}) p[j] = QuantizeSnorm(normal[j]);
+               }
+               p[3] = 0;
+             }
+           });
+         }});
+  } else if (!options.faceted) {
+    streams.push_back({"NORMAL", kFloat, "VEC3", false, numVert, 12,
+                       kArrayBuffer, "", nullptr, getNormals});
+  }
+
+  if (!colors.empty()) {
+    if (quantize) {
+      streams.push_back(
+          {"COLOR_0", kUnsignedByte, "VEC4", true, numVert, 4, kArrayBuffer,
+           "", nullptr, [&](int first, int n, char* out) {
+             ParallelFor(n, [&](size_t begin, size_t end) {
+               for (size_t i = begin; i < end; ++i) {
+                 const glm::vec4 c =
+                     glm::clamp(colors[first + i], 0.0f, 1.0f);
+                 for (int j : {0, 1, 2, 3})
+                   out[4 * i + j] = std::lround(255 * c[j]);
+               }
+             });
+           }});
+    } else {
+      streams.push_back({"COLOR_0", kFloat, "VEC4", false, numVert, 16,
+                         kArrayBuffer, "", nullptr,
+                         [&](int first, int n, char* out) {
+                           std::memcpy(out, colors.data() + first, 16 * n);
+                         }});
+    }
+  }
+
+  const bool shortIndex = quantize && numVert <= 65536;
+  std::vector<uint32_t> tris;
+  streams.push_back(
+      {nullptr, shortIndex ? kUnsignedShort : kUnsignedInt, "SCALAR", false,
+       3 * numTri, shortIndex ? 2 : 4, kElementArrayBuffer, "", nullptr,
+       [&](int first, int n, char* out) {
+         // Indices are filled three per triangle.
+         GetTris(manifold, first / 3, n / 3, tris);
+         if (shortIndex) {
+           for (int i = 0; i < n; ++i)
+             reinterpret_cast<uint16_t*>(out)[i] = tris[i];
+         } else {
+           std::memcpy(out, tris.data(), 4 * n);
+         }
+       }});
+
+  // Fills a stream a chunk at a time, with index chunks whole triangles.
+  auto forEachChunk = [&](const GlbStream& stream, auto func) {
+    const int chunk = stream.attribute ? kExportChunk : 3 * kExportChunk;
+    for (int first = 0; first < stream.count; first += chunk) {
+      const int n = std::min(chunk, stream.count - first);
+      records.resize(static_cast<size_t>(stream.stride) * n);
+      stream.fill(first, n, records.data());
+      func(n);
+    }
+  };
+
+  std::vector<size_t> viewOffset, viewLength, encodedLength;
+  std::vector<std::string> encoded;
+  size_t binLength = 0;
+  size_t fallbackLength = 0;
+  for (const GlbStream& stream : streams) {
+    const size_t length = static_cast<size_t>(stream.stride) * stream.count;
+    viewLength.push_back(length);
+    if (compress) {
+      std::string data;
+      if (stream.attribute) {
+        VertexEncoder encoder(stream.stride);
+        forEachChunk(stream, [&](int n) { encoder.Add(records.data(), n); });
+        data = encoder.Finish();
+      } else {
+        IndexEncoder encoder;
+        std::vector<uint32_t> indices;
+        forEachChunk(stream, [&](int n) {
+          indices.resize(n);
+          for (int i = 0; i < n; ++i)
+            indices[i] = stream.stride == 2
+                             ? reinterpret_cast<uint16_t*>(records.data())[i]
+                             : reinterpret_cast<uint32_t*>(records.data())[i];
+          encoder.Add(indices.data(), n);
+        });
+        data = encoder.Finish();
+      }
+      viewOffset.push_back(fallbackLength);
+      fallbackLength += (length + 3) / 4 * 4;
+      // The decoder finds the tail at the end, so the padding is not counted.
+      encodedLength.push_back(data.size());
+      data.resize((data.size() + 3) / 4 * 4, 0);
+      binLength += data.size();
+      encoded.push_back(std::move(data));
+    } else {
+      viewOffset.push_back(binLength);
+      binLength += (length + 3) / 4 * 4;
+    }
+  }
+
+  std::ostringstream json;
+  json << "{\"asset\":{\"version\":\"2.0\",\"generator\":\"manifold\"},";
+  if (quantize || compress) {
+    std::string extensions = quantize ? "\"KHR_mesh_quantization\"" : "";
+    if (compress)
+      extensions += std::string(quantize ? "," : "") +
+                    "\"EXT_meshopt_compression\"";
+    json << "\"extensionsUsed\":[" << extensions
+         << "],\"extensionsRequired\":[" << extensions << "],";
+  }
+  json << "\"scene\":0,\"scenes\":[{\"nodes\":[0]}],\"nodes\":[{\"mesh\":0";
+  if (quantize)
+    json << ",\"translation\":" << JsonVec3(center)
+         << ",\"scale\":" << JsonVec3(glm::vec3(scale));
+  json << "}],\"meshes\":[{\"primitives\":[{\"attributes\":{";
+  for (int i = 0; i + 1 < streams.size(); ++i)
+    json << (i > 0 ? "," : "") << "\"" << streams[i].attribute << "\":" << i;
+  json << "},\"indices\":" << streams.size() - 1
+       << ",\"material\":0,\"mode\":4}]}],";
+  const glm::vec4& color = options.mat.color;
+  json << "\"materials\":[{\"pbrMetallicRoughness\":{\"baseColorFactor\":["
+       << JsonFloat(color.r) << "," << JsonFloat(color.g) << ","
+       << JsonFloat(color.b) << "," << JsonFloat(color.a)
+       << "],\"metallicFactor\":" << JsonFloat(options.mat.metalness)
+       << ",\"roughnessFactor\":" << JsonFloat(options.mat.roughness) << "}}],";
+  json << "\"accessors\":[";
+  for (int i = 0; i < streams.size(); ++i) {
+    const GlbStream& stream = streams[i];
+    json << (i > 0 ? "," : "") << "{\"bufferView\":" << i
+         << ",\"componentType\":" << stream.componentType
+         << ",\"count\":" << stream.count << ",\"type\":\"" << stream.type
+         << "\"";
+    if (stream.normalized) json << ",\"normalized\":true";
+    if (!stream.bounds.empty()) json << "," << stream.bounds;
+    json << "}";
+  }
+  json << "],\"bufferViews\":[";
+  size_t compressedOffset = 0;
+  for (int i = 0; i < streams.size(); ++i) {
+    const GlbStream& stream = streams[i];
+    json << (i > 0 ? "," : "") << "{\"buffer\":" << (compress ? 1 : 0)
+         << ",\"byteOffset\":" << viewOffset[i]
+         << ",\"byteLength\":" << viewLength[i];
+    if (stream.attribute) json << ",\"byteStride\":" << stream.stride;
+    json << ",\"target\":" << stream.target;
+    if (compress) {
+      json << ",\"extensions\":{\"EXT_meshopt_compression\":{\"buffer\":0,"
+           << "\"byteOffset\":" << compressedOffset
+           << ",\"byteLength\":" << encodedLength[i]
+           << ",\"byteStride\":" << stream.stride
+           << ",\"count\":" << stream.count << ",\"mode\":\""
+           << (stream.attribute ? "ATTRIBUTES" : "INDICES") << "\"";
+      if (stream.filter)
+        json << ",\"filter\":\"" << stream.filter << "\"";
+      json << "}}";
+      compressedOffset += encoded[i].size();
+    }
+    json << "}";
+  }
+  json << "],\"buffers\":[{\"byteLength\":" << binLength << "}";
+  // The uncompressed data has no storage; decoders recreate it.
+  if (compress)
+    json << ",{\"byteLength\":" << fallbackLength
+         << ",\"extensions\":{\"EXT_meshopt_compression\":"
+         << "{\"fallback\":true}}}";
+  json << "]}";
+  std::string jsonChunk = json.str();
+  jsonChunk.resize((jsonChunk.size() + 3) / 4 * 4, ' ');
+
+  const uint64_t totalLength = 12 + 8 + jsonChunk.size() + 8 + binLength;
+  ALWAYS_ASSERT(totalLength <= std::numeric_limits<uint32_t>::max(), userErr,
+                "GLB files are limited to 4 GB.");
+  std::ofstream out = OpenOutput(filename);
+  char header[20];
+  char* p = header;
+  Put<uint32_t>(p, 0x46546C67);  // glTF
+  Put<uint32_t>(p, 2);
+  Put<uint32_t>(p, totalLength);
+  Put<uint32_t>(p, jsonChunk.size());
+  Put<uint32_t>(p, 0x4E4F534A);  // JSON
+  out.write(header, 20);
+  out.write(jsonChunk.data(), jsonChunk.size());
+  p = header;
+  Put<uint32_t>(p, binLength);
+  Put<uint32_t>(p, 0x004E4942);  // BIN
+  out.write(header, 8);
+
+  if (compress) {
+    for (const std::string& data : encoded) out.write(data.data(), data.size());
+  } else {
+    for (int i = 0; i < streams.size(); ++i) {
+      forEachChunk(streams[i],
+                   [&](int n) { out.write(records.data(), records.size()); });
+      const char padding[4] = {0, 0, 0, 0};
+      out.write(padding, (4 - viewLength[i] % 4) % 4);
+    }
+  }
+  CheckOutput(out, filename);
+}
+
+struct CrcTable {
+  CrcTable() {
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; ++k) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      entry[i] = c;
+    }
+  }
+  uint32_t entry[256];
+};
+
+/**
+ * The zip (IEEE) CRC-32 of size bytes of data.
+ */
+uint32_t Crc32(const char* data, size_t size) {
+  static const CrcTable table;
+  uint32_t crc = 0xFFFFFFFFu;
+  for (size_t i = 0; i < size; ++i)
+    crc = table.entry[(crc ^ static_cast<uint8_t>(data[i])) & 0xFF] ^
+          (crc >> 8);
+  return crc ^ 0xFFFFFFFFu;
+}
+
+// Multiplies vec by a 32x32 matrix over GF(2), stored by columns.
+uint32_t Gf2Times(const uint32_t* mat, uint32_t vec) {
+  uint32_t sum = 0;
+  for (; vec != 0; vec >>= 1, ++mat)
+    if (vec & 1) sum ^= *mat;
+  return sum;
+}
+
+void Gf2Square(uint32_t* square, const uint32_t* mat) {
+  for (int n = 0; n < 32; ++n) square[n] = Gf2Times(mat, mat[n]);
+}
+
+/**
+ * The CRC-32 of A followed by B, given crcA, and crcB of the sizeB bytes of B,
+ * as zlib's crc32_combine() computes it: crcA is advanced past sizeB zero
+ * bytes by repeatedly squaring the one-zero-bit operator.
+ */
+uint32_t Crc32Combine(uint32_t crcA, uint32_t crcB, uint64_t sizeB) {
+  if (sizeB == 0) return crcA;
+  uint32_t even[32];
+  uint32_t odd[32];
+  odd[0] = 0xEDB88320u;
+  for (int n = 1; n < 32; ++n) odd[n] = 1u << (n - 1);
+  Gf2Square(even, odd);  // two zero bits
+  Gf2Square(odd, even);  // four zero bits
+  while (true) {
+    Gf2Square(even, odd);
+    if (sizeB & 1) crcA = Gf2Times(even, crcA);
+    sizeB >>= 1;
+    if (sizeB == 0) break;
+    Gf2Square(odd, even);
+    if (sizeB & 1) crcA = Gf2Times(odd, crcA);
+    sizeB >>= 1;
+    if (sizeB == 0) break;
+  }
+  return crcA ^ crcB;
+}
+
+/**
+ * Writes a zip archive of uncompressed entries, which is all an OPC package
+ * like 3MF requires. Entries are streamed, so their sizes and CRCs follow them
+ * in data descriptors.
+ */
+class ZipWriter {
+ public:
+  explicit ZipWriter(std::ostream& out) : out_(out) {}
+
+  void Begin(const std::string& name) {
+    entries_.push_back({name, Offset(), 0, 0});
+    char header[30];
+    char* p = header;
+    Put<uint32_t>(p, 0x04034B50);
+    PutCommon(p, entries_.back(), false);
+    out_.write(header, sizeof(header));
+    out_.write(name.data(), name.size());
+  }
+
+  /**
+   * Appends size bytes of data, whose CRC-32 the caller has already computed,
+   * so that it can be done in parallel.
+   */
+  void Write(const char* data, size_t size, uint32_t crc) {
+    Entry& entry = entries_.back();
+    entry.crc = Crc32Combine(entry.crc, crc, size);
+    entry.size += size;
+    out_.write(data, size);
+  }
+
+  void Write(const char* data, size_t size) {
+    Write(data, size, Crc32(data, size));
+  }
+
+  void Write(const std::string& text) { Write(text.data(), text.size()); }
+
+  void End() {
+    const Entry& entry = entries_.back();
+    ALWAYS_ASSERT(entry.size <= std::numeric_limits<uint32_t>::max(), userErr,
+                  "Zip entries are limited to 4 GB.");
+    char descriptor[16];
+    char* p = descriptor;
+    Put<uint32_t>(p, 0x08074B50);
+    Put<uint32_t>(p, entry.crc);
+    Put<uint32_t>(p, entry.size);
+    Put<uint32_t>(p, entry.size);
+    out_.write(descriptor, sizeof(descriptor));
+  }
+
+  void Finish() {
+    const uint64_t start = Offset();
+    for (const Entry& entry : entries_) {
+      char header[46];
+      char* p = header;
+      Put<uint32_t>(p, 0x02014B50);
+      Put<uint16_t>(p, 20);  // made by
+      PutCommon(p, entry, true);
+      Put<uint16_t>(p, 0);  // comment length
+      Put<uint16_t>(p, 0);  // disk
+      Put<uint16_t>(p, 0);  // internal attributes
+      Put<uint32_t>(p, 0);  // external attributes
+      Put<uint32_t>(p, entry.offset);
+      out_.write(header, sizeof(header));
+      out_.write(entry.name.data(), entry.name.size());
+    }
+    const uint64_t end = Offset();
+    ALWAYS_ASSERT(end <= std::numeric_limits<uint32_t>::max(), userErr,
+                  "Zip files are limited to 4 GB.");
+    char footer[22];
+    char* p = footer;
+    Put<uint32_t>(p, 0x06054B50);
+    Put<uint16_t>(p, 0);
+    Put<uint16_t>(p, 0);
+    Put<uint16_t>(p, entries_.size());
+    Put<uint16_t>(p, entries_.size());
+    Put<uint32_t>(p, end - start);
+    Put<uint32_t>(p, start);
+    Put<uint16_t>(p, 0);
+    out_.write(footer, sizeof(footer));
+  }
+
+ private:
+  struct Entry {
+    std::string name;
+    uint64_t offset;
+    uint64_t size;
+    uint32_t crc;
+  };
+
+  uint64_t Offset() { return static_cast<uint64_t>(out_.tellp()); }
+
+  // The fields shared by local and central headers. Local headers leave the
+  // CRC and sizes to the data descriptor.
+  void PutCommon(char*& p, const Entry& entry, bool central) {
+    Put<uint16_t>(p, 20);      // version needed
+    Put<uint16_t>(p, 0x0008);  // data descriptor follows
+    Put<uint16_t>(p, 0);       // stored
+    Put<uint16_t>(p, 0);       // time
+    Put<uint16_t>(p, 0x21);    // date: 1980-01-01
+    Put<uint32_t>(p, central ? entry.crc : 0);
+    Put<uint32_t>(p, central ? entry.size : 0);
+    Put<uint32_t>(p, central ? entry.size : 0);
+    Put<uint16_t>(p, entry.name.size());
+    Put<uint16_t>(p, 0);  // extra length
+  }
+
+  std::ostream& out_;
+  std::vector<Entry> entries_;
+};
+
+/**
+ * Encodes n items as text in parallel, by calling encode(i, text, buffer) for
+ * each one to append to its thread's text, and writes them in order. Each
+ * thread also computes the CRC of its text, which the writer combines.
+ */
+template <typename Encode>
+void WriteText(ZipWriter& zip, int n, Encode encode) {
+  const int numChunks = NumChunks(n);
+  std::vector<std::string> text(numChunks);
+  std::vector<uint32_t> crc(numChunks);
+  ParallelChunks(numChunks, [&](int chunk) {
+    char buffer[128];
+    for (int i = n * chunk / numChunks; i < n * (chunk + 1) / numChunks; ++i)
+      encode(i, text[chunk], buffer);
+    crc[chunk] = Crc32(text[chunk].data(), text[chunk].size());
+  });
+  for (int chunk = 0; chunk < numChunks; ++chunk)
+    zip.Write(text[chunk].data(), text[chunk].size(), crc[chunk]);
+}
+
+void Write3MF(const std::string& filename, const Manifold& manifold) {
+  const int numVert = manifold.NumVert();
+  const int numTri = manifold.NumTri();
+  std::ofstream out = OpenOutput(filename);
+  ZipWriter zip(out);
+
+  zip.Begin("[Content_Types].xml");
+  zip.Write(
+      "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      "<Types xmlns=\"http://schemas.openxmlformats.org/package/2006/"
+      "content-types\">"
+      "<Default Extension=\"rels\" ContentType=\"application/"
+      "vnd.openxmlformats-package.relationships+xml\"/>"
+      "<Default Extension=\"model\" ContentType=\"application/"
+      "vnd.ms-package.3dmanufacturing-3dmodel+xml\"/></Types>\n");
+  zip.End();
+
+  zip.Begin("_rels/.rels");
+  zip.Write(
+      "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/"
+      "relationships\"><Relationship Target=\"/3D/3dmodel.model\" "
+      "Id=\"rel0\" Type=\"http://schemas.microsoft.com/3dmanufacturing/2013/"
+      "01/3dmodel\"/></Relationships>\n");
+  zip.End();
+
+  zip.Begin("3D/3dmodel.model");
+  zip.Write(
+      "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      "<model unit=\"millimeter\" xml:lang=\"en-US\" "
+      "xmlns=\"http://schemas.microsoft.com/3dmanufacturing/core/2015/02\">\n"
+      "<resources><object id=\"1\" type=\"model\"><mesh><vertices>\n");
+  std::vector<glm::vec3> vertPos;
+  ForEachChunk(numVert, [&](int first, int n) {
+    vertPos.resize(n);
+    GetVerts(manifold, first, n, reinterpret_cast<char*>(vertPos.data()), 12,
+             false);
+    WriteText(zip, n, [&](int i, std::string& text, char* buffer) {
+      const glm::vec3& v = vertPos[i];
+      text.append(buffer, std::snprintf(
+                              buffer, 128,
+                              "<vertex x=\"%.9g\" y=\"%.9g\" z=\"%.9g\"/>\n",
+                              v.x, v.y, v.z));
+    });
+  });
+  zip.Write("</vertices><triangles>\n");
+  std::vector<uint32_t> tris;
+  ForEachChunk(numTri, [&](int first, int n) {
+    GetTris(manifold, first, n, tris);
+    WriteText(zip, n, [&](int i, std::string& text, char* buffer) {
+      text.append(buffer, std::snprintf(
+                              buffer, 128,
+                              "<triangle v1=\"%u\" v2=\"%u\" v3=\"%u\"/>\n",
+                              tris[3 * i], tris[3 * i + 1], tris[3 * i + 2]));
+    });
+  });
+  zip.Write(
+      "</triangles></mesh></object></resources>\n"
+      "<build><item objectid=\"1\"/></build></model>\n");
+  zip.End();
+  zip.Finish();
+  CheckOutput(out, filename);
+}
+}  // namespace
+
+namespace manifold {
+
+MappedFile::MappedFile(const std::string& filename) {
+#ifdef _WIN32
+  HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING,
+                            FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  ALWAYS_ASSERT(file != INVALID_HANDLE_VALUE, userErr,
+                "Cannot open file " + filename);
+  file_ = file;
+  LARGE_INTEGER size;
+  GetFileSizeEx(file, &size);
+  size_ = size.QuadPart;
+  if (size_ == 0) return;
+  mapping_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mapping_ != nullptr)
+    data_ = static_cast<const char*>(
+        MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+  if (data_ == nullptr) {
+    if (mapping_ != nullptr) CloseHandle(mapping_);
+    CloseHandle(file);
+  }
+#else
+  const int fd = open(filename.c_str(), O_RDONLY);
+  ALWAYS_ASSERT(fd >= 0, userErr, "Cannot open file " + filename);
+  struct stat info;
+  if (fstat(fd, &info) == 0) size_ = info.st_size;
+  if (size_ == 0) {
+    close(fd);
+    return;
+  }
+  void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data != MAP_FAILED) {
+    data_ = static_cast<const char*>(data);
+    // The file is read by many threads at once, in order within each.
+    madvise(data, size_, MADV_WILLNEED);
+  }
+#endif
+  ALWAYS_ASSERT(data_ != nullptr, userErr, "Cannot map file " + filename);
+}
+
+MappedFile::~MappedFile() {
+#ifdef _WIN32
+  if (data_ != nullptr) UnmapViewOfFile(data_);
+  if (mapping_ != nullptr) CloseHandle(mapping_);
+  if (file_ != nullptr) CloseHandle(file_);
+#else
+  if (data_ != nullptr) munmap(const_cast<char*>(data_), size_);
+#endif
+}
+
+/**
+ * Reads binary and ASCII STL, binary and ASCII PLY, and OBJ files directly
+ * from a memory mapping, parsing chunks of the file on up to
+ * ExecutionContext::maxThreads threads. Polygons are triangulated as fans.
+ *
+ * @return false if the file uses a variant these readers do not handle, which
+ * leaves mesh empty.
+ */
+bool ImportNative(const std::string& filename, const std::string& ext,
+                  Mesh& mesh) {
+  if (ext != "stl" && ext != "ply" && ext != "obj") return false;
+  MappedFile file(filename);
+  bool success = true;
+  if (ext == "stl") {
+    if (IsBinarySTL(file))
+      ReadBinarySTL(file, mesh);
+    else
+      ReadAsciiSTL(file, mesh);
+  } else if (ext == "ply") {
+    success = ReadPLY(file, mesh);
+  } else {
+    ReadOBJ(file, mesh);
+  }
+  if (!success) mesh = Mesh();
+  for (const glm::ivec3& tri : mesh.triVerts) {
+    for (int j : {0, 1, 2})
+      ALWAYS_ASSERT(tri[j] >= 0 && tri[j] < mesh.vertPos.size(), userErr,
+                    "Face index out of range in " + filename);
+  }
+  return success;
+}
+
+/**
+ * Writes binary STL, binary PLY, GLB and 3MF files directly from the
+ * Manifold, extracting and encoding a chunk of vertices or triangles at a
+ * time in parallel, so that no full copy of the mesh is made.
+ *
+ * @return false if ext is not one of these formats.
+ */
+bool ExportNative(const std::string& filename, const std::string& ext,
+                  const Manifold& manifold, const ExportOptions& options) {
+  if (ext == "stl")
+    WriteSTL(filename, manifold);
+  else if (ext == "ply")
+    WritePLY(filename, manifold, options);
+  else if (ext == "glb")
+    WriteGLB(filename, manifold, options);
+  else if (ext == "3mf")
+    Write3MF(filename, manifold);
+  else
+    return false;
+  return true;
+}
+}  // namespace manifold
@@ -0,0 +1,54 @@
+// Copyright 2022 Emmett Lalish
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <string>
+
+#include "meshIO.h"
+
+namespace manifold {
+
+/** @addtogroup Private
+ *  @{
+ */
+
+/**
+ * A read-only memory mapping of a whole file.
+ */
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& filename);
+  ~MappedFile();
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const char* begin() const { return data_; }
+  const char* end() const { return data_ + size_; }
+  size_t size() const { return size_; }
+
+ private:
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+#ifdef _WIN32
+  void* file_ = nullptr;
+  void* mapping_ = nullptr;
+#endif
+};
+
+bool ImportNative(const std::string& filename, const std::string& ext,
+                  Mesh& mesh);
+bool ExportNative(const std::string& filename, const std::string& ext,
+                  const Manifold& manifold, const ExportOptions& options);
+/** @} */
+}  // namespace manifold
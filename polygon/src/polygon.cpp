@@ -23,11 +23,11 @@
 #include <set>
 #include <stack>
 
+#include "context.h"
+
 namespace {
 using namespace manifold;
 
-ExecutionParams params;
-
 /**
  * The class first turns input polygons into monotone polygons, then
  * triangulates them using the above class.
@@ -74,7 +74,7 @@ class Monotones {
     int triangles_left = monotones_.size();
     VertItr start = monotones_.begin();
     while (start != monotones_.end()) {
-      if (params.verbose) std::cout << start->mesh_idx << std::endl;
+      if (PolygonParams().verbose) std::cout << start->mesh_idx << std::endl;
       Triangulator triangulator(start, precision_);
       start->SetProcessed(true);
       VertItr vR = start->right;
@@ -82,18 +82,18 @@ class Monotones {
       while (vR != vL) {
         // Process the neighbor vert that is next in the sweep-line.
         if (vR->index < vL->index) {
-          if (params.verbose) std::cout << vR->mesh_idx << std::endl;
+          if (PolygonParams().verbose) std::cout << vR->mesh_idx << std::endl;
           triangulator.ProcessVert(vR, true, false, triangles);
           vR->SetProcessed(true);
           vR = vR->right;
         } else {
-          if (params.verbose) std::cout << vL->mesh_idx << std::endl;
+          if (PolygonParams().verbose) std::cout << vL->mesh_idx << std::endl;
           triangulator.ProcessVert(vL, false, false, triangles);
           vL->SetProcessed(true);
           vL = vL->left;
         }
       }
-      if (params.verbose) std::cout << vR->mesh_idx << std::endl;
+      if (PolygonParams().verbose) std::cout << vR->mesh_idx << std::endl;
       triangulator.ProcessVert(vR, true, true, triangles);
       vR->SetProcessed(true);
       // validation
@@ -109,9 +109,9 @@ class Monotones {
   }
 
   // A variety of sanity checks on the data structure. Expensive checks are only
-  // performed if params.intermediateChecks = true.
+  // performed if PolygonParams().intermediateChecks = true.
   void Check() {
-    if (!params.intermediateChecks) return;
+    if (!PolygonParams().intermediateChecks) return;
     std::vector<Halfedge> edges;
     for (VertItr vert = monotones_.begin(); vert != monotones_.end(); vert++) {
       vert->SetProcessed(false);
@@ -121,7 +121,7 @@ class Monotones {
       ALWAYS_ASSERT(vert->left->right == vert, topologyErr,
                     "monotone vert neighbors don't agree!");
     }
-    if (params.verbose) {
+    if (PolygonParams().verbose) {
       VertItr start = monotones_.begin();
       while (start != monotones_.end()) {
         start->SetProcessed(true);
@@ -253,7 +253,7 @@ class Monotones {
       if (onRight_ == onRight && !last) {
         // This only creates enough triangles to ensure the reflex chain is
         // still reflex.
-        if (params.verbose) std::cout << "same chain" << std::endl;
+        if (PolygonParams().verbose) std::cout << "same chain" << std::endl;
         int ccw = CCW(vi->pos, vj->pos, v_top->pos, precision_);
         while (ccw == (onRight_ ? 1 : -1) || ccw == 0) {
           AddTriangle(triangles, vi, vj, v_top);
@@ -269,7 +269,8 @@ class Monotones {
         // This branch empties the reflex chain and switches sides. It must be
         // used for the last point, as it will output all the triangles
         // regardless of geometry.
-        if (params.verbose) std::cout << "different chain" << std::endl;
+        if (PolygonParams().verbose)
+          std::cout << "different chain" << std::endl;
         onRight_ = !onRight_;
         VertItr v_last = v_top;
         while (!reflex_chain_.empty()) {
@@ -296,7 +297,7 @@ class Monotones {
       if (!onRight_) std::swap(v1, v2);
       triangles.emplace_back(v0->mesh_idx, v1->mesh_idx, v2->mesh_idx);
       ++triangles_output_;
-      if (params.verbose) std::cout << triangles.back() << std::endl;
+      if (PolygonParams().verbose) std::cout << triangles.back() << std::endl;
     }
   };
 
@@ -350,33 +351,33 @@ class Monotones {
       if (vert->left->Processed()) {
         if (westPair == eastPair) {
           // facing in
-          if (params.verbose) std::cout << "END" << std::endl;
+          if (PolygonParams().verbose) std::cout << "END" << std::endl;
           CloseEnd(vert);
           return END;
         } else if (westPair != activePairs_.end() &&
                    std::next(westPair) == eastPair) {
           // facing out
-          if (params.verbose) std::cout << "MERGE" << std::endl;
+          if (PolygonParams().verbose) std::cout << "MERGE" << std::endl;
           CloseEnd(vert);
           // westPair will be removed and eastPair takes over.
           SetVWest(eastPair, westPair->vWest);
           return MERGE;
         } else {  // not neighbors
-          if (params.verbose) std::cout << "SKIP" << std::endl;
+          if (PolygonParams().verbose) std::cout << "SKIP" << std::endl;
           return SKIP;
         }
       } else {
         SetVWest(eastPair, vert);
-        if (params.verbose) std::cout << "WESTSIDE" << std::endl;
+        if (PolygonParams().verbose) std::cout << "WESTSIDE" << std::endl;
         return WESTSIDE;
       }
     } else {
       if (vert->left->Processed()) {
         SetVEast(westPair, vert);
-        if (params.verbose) std::cout << "EASTSIDE" << std::endl;
+        if (PolygonParams().verbose) std::cout << "EASTSIDE" << std::endl;
         return EASTSIDE;
       } else {
-        if (params.verbose) std::cout << "START" << std::endl;
+        if (PolygonParams().verbose) std::cout << "START" << std::endl;
         return START;
       }
     }
@@ -588,7 +589,7 @@ class Monotones {
         starts.pop_back();
       }
 
-      if (params.verbose)
+      if (PolygonParams().verbose)
         std::cout << "mesh_idx = " << vert->mesh_idx << std::endl;
 
       if (vert->Processed()) continue;
@@ -622,7 +623,7 @@ class Monotones {
             !nextAttached.empty() || !starts.empty(), geometryErr,
             "Not Geometrically Valid! Tried to skip last queued vert.");
         skipped.push_back(vert);
-        if (params.verbose) std::cout << "Skipping vert" << std::endl;
+        if (PolygonParams().verbose) std::cout << "Skipping vert" << std::endl;
         // If a new pair was added, remove it.
         if (newPair != activePairs_.end()) {
           activePairs_.erase(newPair);
@@ -666,7 +667,7 @@ class Monotones {
       }
 
       // Debug
-      if (params.verbose) ListPairs();
+      if (PolygonParams().verbose) ListPairs();
     }
     return false;
   }  // namespace
@@ -679,7 +680,7 @@ class Monotones {
    */
   VertItr SplitVerts(VertItr north, VertItr south) {
     // at split events, add duplicate vertices to end of list and reconnect
-    if (params.verbose)
+    if (PolygonParams().verbose)
       std::cout << "split from " << north->mesh_idx << " to " << south->mesh_idx
                 << std::endl;
 
@@ -712,7 +713,7 @@ class Monotones {
     while (vert != monotones_.begin()) {
       --vert;
 
-      if (params.verbose)
+      if (PolygonParams().verbose)
         std::cout << "mesh_idx = " << vert->mesh_idx << std::endl;
 
       if (vert->Processed()) continue;
@@ -776,7 +777,7 @@ class Monotones {
       vert->SetProcessed(true);
 
       // Debug
-      if (params.verbose) ListPairs();
+      if (PolygonParams().verbose) ListPairs();
     }
     return false;
   }
@@ -830,12 +831,12 @@ std::vector<glm::ivec3> Triangulate(const Polygons &polys, float precision) {
   try {
     Monotones monotones(polys, precision);
     monotones.Triangulate(triangles);
-    if (params.intermediateChecks) {
+    if (PolygonParams().intermediateChecks) {
       CheckTopology(triangles, polys);
       CheckGeometry(triangles, polys, precision);
     }
   } catch (const geometryErr &e) {
-    if (!params.suppressErrors) {
+    if (!PolygonParams().suppressErrors) {
       PrintFailure(e, polys, triangles);
     }
     throw;
@@ -953,6 +954,9 @@ void Dump(const Polygons &polys) {
   }
 }
 
-ExecutionParams &PolygonParams() { return params; }
+/**
+ * The triangulator settings of the current ExecutionContext.
+ */
+ExecutionParams &PolygonParams() { return CurrentContext().polygonParams; }
 
 }  // namespace manifold
@@ -12,11 +12,24 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
 #include <random>
+#include <thread>
+#include <unordered_set>
 
 #include "manifold.h"
 #include "meshIO.h"
 #include "test.h"
+#include "vec_dh.h"
 
 namespace {
 
@@ -48,6 +61,150 @@ Mesh Csaszar() {
   return csaszar;
 }
 
+uint32_t Crc32(const std::string& data) {
+  uint32_t crc = 0xFFFFFFFFu;
+  for (char c : data) {
+    crc ^= static_cast<uint8_t>(c);
+    for (int k = 0; k < 8; ++k)
+      crc = crc & 1 ? 0xEDB88320u ^ (crc >> 1) : crc >> 1;
+  }
+  return crc ^ 0xFFFFFFFFu;
+}
+
+std::string ReadFile(const std::string& filename) {
+  std::ifstream file(filename, std::ios::binary);
+  return std::string((std::istreambuf_iterator<char>(file)),
+                     std::istreambuf_iterator<char>());
+}
+
+// The number following the first "key": at or after pos, which moves past it.
+int JsonInt(const std::string& json, size_t& pos, const std::string& key) {
+  pos = json.find("\"" + key + "\":", pos);
+  if (pos == std::string::npos) {
+    ADD_FAILURE() << key;
+    return 0;
+  }
+  char* end;
+  const int value = std::strtol(json.c_str() + pos + key.size() + 3, &end, 10);
+  pos = end - json.c_str();
+  return value;
+}
+
+glm::vec3 JsonVec3(const std::string& json, const std::string& key) {
+  glm::vec3 v(0);
+  const size_t pos = json.find("\"" + key + "\":[");
+  if (pos == std::string::npos) {
+    ADD_FAILURE() << key;
+    return v;
+  }
+  const char* p = json.c_str() + pos + key.size() + 4;
+  for (int i : {0, 1, 2}) {
+    char* end;
+    v[i] = std::strtof(p, &end);
+    p = end + 1;
+  }
+  return v;
+}
+
+/**
+ * Decodes size bytes in groups of 16 of meshoptimizer's vertex codec, after
+ * a header of two bits per group giving their widths.
+ */
+const uint8_t* DecodeBytes(const uint8_t* data, uint8_t* out, int size) {
+  const int numGroups = size / 16;
+  const uint8_t* header = data;
+  data += (numGroups + 3) / 4;
+  for (int g = 0; g < numGroups; ++g) {
+    const int mode = header[g / 4] >> (g % 4 * 2) & 3;
+    uint8_t* group = out + 16 * g;
+    if (mode == 0) {
+      std::fill(group, group + 16, 0);
+    } else if (mode == 3) {
+      std::copy(data, data + 16, group);
+      data += 16;
+    } else {
+      const int bits = 1 << mode;
+      const int sentinel = (1 << bits) - 1;
+      for (int i = 0; i < 16; ++i)
+        group[i] = data[i * bits / 8] >> (8 - bits * (i % (8 / bits) + 1)) &
+                   sentinel;
+      data += 2 * bits;
+      for (int i = 0; i < 16; ++i)
+        if (group[i] == sentinel) group[i] = *data++;
+    }
+  }
+  return data;
+}
+
+/**
+ * Decodes count elements of stride bytes from EXT_meshopt_compression's
+ * ATTRIBUTES mode.
+ */
+std::vector<uint8_t> DecodeVertices(const std::string& encoded, int count,
+                                    int stride) {
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(encoded.data());
+  const uint8_t* tail = data + encoded.size() - std::max(32, stride);
+  EXPECT_EQ(data[0], 0xA0);
+  std::vector<uint8_t> last(data + encoded.size() - stride,
+                            data + encoded.size());
+  std::vector<uint8_t> out(count * stride);
+  const int blockSize = std::min((8192 / stride) & ~15, 256);
+  uint8_t deltas[256];
+  ++data;
+  for (int first = 0; first < count; first += blockSize) {
+    const int n = std::min(blockSize, count - first);
+    for (int k = 0; k < stride; ++k) {
+      data = DecodeBytes(data, deltas, (n + 15) & ~15);
+      for (int i = 0; i < n; ++i) {
+        last[k] += (deltas[i] >> 1) ^ -(deltas[i] & 1);
+        out[stride * (first + i) + k] = last[k];
+      }
+    }
+  }
+  EXPECT_EQ(data, tail);
+  return out;
+}
+
+/**
+ * Decodes count indices from EXT_meshopt_compression's INDICES mode.
+ */
+std::vector<uint32_t> DecodeIndices(const std::string& encoded, int count) {
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(encoded.data());
+  const uint8_t* tail = data + encoded.size() - 4;
+  EXPECT_EQ(data[0], 0xD1);
+  ++data;
+  uint32_t last[2] = {0, 0};
+  std::vector<uint32_t> out(count);
+  for (int i = 0; i < count; ++i) {
+    uint32_t v = 0;
+    for (int shift = 0;; shift += 7) {
+      const uint8_t byte = *data++;
+      v |= (byte & 127u) << shift;
+      if (byte < 128) break;
+    }
+    const int current = v & 1;
+    v >>= 1;
+    last[current] += (v >> 1) ^ -(v & 1);
+    out[i] = last[current];
+  }
+  EXPECT_EQ(data, tail);
+  return out;
+}
+
+/**
+ * The average cache miss ratio: vertices transformed per triangle drawn,
+ * simulating a post-transform vertex cache of 16 entries in FIFO order.
+ */
+float ACMR(const Mesh& mesh) {
+  const int kCacheSize = 16;
+  std::vector<int> inserted(mesh.vertPos.size(), -kCacheSize);
+  int misses = 0;
+  for (const glm::ivec3& tri : mesh.triVerts)
+    for (int i : {0, 1, 2})
+      if (misses - inserted[tri[i]] >= kCacheSize) inserted[tri[i]] = misses++;
+  return static_cast<float>(misses) / mesh.triVerts.size();
+}
+
 void Identical(const Mesh& mesh1, const Mesh& mesh2) {
   ASSERT_EQ(mesh1.vertPos.size(), mesh2.vertPos.size());
   for (int i = 0; i < mesh1.vertPos.size(); ++i)
@@ -155,6 +312,302 @@ TEST(MeshIO, ReadWrite) {
   Identical(mesh, mesh_out);
 }
 
+TEST(MeshIO, Native) {
+  std::ofstream obj("data/cube.obj");
+  for (int i = 0; i < 8; ++i)
+    obj << "v " << (i & 1) << " " << (i >> 1 & 1) << " " << (i >> 2) << "\n";
+  const int quads[6][4] = {{0, 2, 3, 1}, {4, 5, 7, 6}, {0, 1, 5, 4},
+                           {2, 6, 7, 3}, {0, 4, 6, 2}, {1, 3, 7, 5}};
+  for (int face = 0; face < 6; ++face) {
+    obj << "f";
+    for (int vert : quads[face]) {
+      if (face % 2)
+        obj << " " << vert - 8;
+      else
+        obj << " " << vert + 1 << "/1/1";
+    }
+    obj << "\n";
+  }
+  obj.close();
+  Mesh cube = ImportMesh("data/cube.obj");
+  EXPECT_EQ(cube.vertPos.size(), 8);
+  EXPECT_EQ(cube.triVerts.size(), 12);
+  Manifold fromObj(cube);
+  EXPECT_TRUE(fromObj.IsManifold());
+  EXPECT_FLOAT_EQ(fromObj.GetProperties().volume, 1.0f);
+
+  // Indices that do not fit in an int must be rejected rather than wrap into
+  // range, and huge numbers must not overflow while being parsed.
+  const std::string badObj = ::testing::TempDir() + "manifold_bad_index.obj";
+  const std::string badFaces[] = {"f 1 2 4294967298",
+                                  "f 1 2 -4294967294",
+                                  "f 1 2 99999999999999999999999999"};
+  for (const std::string& face : badFaces) {
+    std::ofstream bad(badObj);
+    bad << "v 0 0 0\nv 1 0 0\nv 0 1 0\n" << face << "\n";
+    bad.close();
+    EXPECT_THROW(ImportMesh(badObj), userErr);
+  }
+  std::ofstream huge(badObj);
+  huge << "v 1e99999999999999999999 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n";
+  huge.close();
+  EXPECT_TRUE(std::isinf(ImportMesh(badObj).vertPos[0].x));
+  std::remove(badObj.c_str());
+
+  // STL stores every triangle's vertices separately; they must be merged.
+  std::ofstream stl("data/cube.stl", std::ios::binary);
+  const std::string header(80, ' ');
+  stl.write(header.data(), header.size());
+  const uint32_t numTri = cube.triVerts.size();
+  stl.write(reinterpret_cast<const char*>(&numTri), 4);
+  for (const glm::ivec3& tri : cube.triVerts) {
+    const glm::vec3 normal(0.0f);
+    stl.write(reinterpret_cast<const char*>(&normal), 12);
+    for (int i : {0, 1, 2})
+      stl.write(reinterpret_cast<const char*>(&cube.vertPos[tri[i]]), 12);
+    const uint16_t attributes = 0;
+    stl.write(reinterpret_cast<const char*>(&attributes), 2);
+  }
+  stl.close();
+  Mesh fromStl = ImportMesh("data/cube.stl");
+  EXPECT_EQ(fromStl.vertPos.size(), 8);
+  EXPECT_EQ(fromStl.triVerts.size(), 12);
+  EXPECT_TRUE(Manifold(fromStl).IsManifold());
+}
+
+TEST(MeshIO, ExportManifold) {
+  const Manifold sphere = Manifold::Sphere(1, 32);
+  const Mesh mesh = sphere.GetMesh();
+
+  ExportOptions options;
+  options.faceted = false;
+  ExportMesh("data/sphere.ply", sphere, options);
+  Identical(mesh, ImportMesh("data/sphere.ply"));
+
+  ExportMesh("data/sphere.stl", sphere, {});
+  Mesh stl = ImportMesh("data/sphere.stl");
+  EXPECT_EQ(stl.vertPos.size(), mesh.vertPos.size());
+  EXPECT_EQ(stl.triVerts.size(), mesh.triVerts.size());
+
+  ExportMesh("data/sphere.glb", sphere, options);
+  Mesh glb = ImportMesh("data/sphere.glb");
+  EXPECT_EQ(glb.triVerts.size(), mesh.triVerts.size());
+  EXPECT_TRUE(Manifold(glb).IsManifold());
+
+  ExportMesh("data/sphere.3mf", sphere, {});
+  std::ifstream file("data/sphere.3mf", std::ios::binary);
+  const std::string zip((std::istreambuf_iterator<char>(file)),
+                        std::istreambuf_iterator<char>());
+  ASSERT_GE(zip.size(), 22u);
+  EXPECT_EQ(zip.substr(0, 4), std::string("PK\3\4", 4));
+  // Zip fields are little-endian, as is every platform we test on.
+  auto get = [&](size_t offset, int bytes) {
+    uint32_t value = 0;
+    std::memcpy(&value, zip.data() + offset, bytes);
+    return value;
+  };
+  const size_t footer = zip.size() - 22;
+  ASSERT_EQ(get(footer, 4), 0x06054B50u);
+  const int numEntries = get(footer + 10, 2);
+  EXPECT_EQ(numEntries, 3);
+  size_t central = get(footer + 16, 4);
+  std::string model;
+  for (int i = 0; i < numEntries; ++i) {
+    ASSERT_EQ(get(central, 4), 0x02014B50u);
+    const uint32_t crc = get(central + 16, 4);
+    const uint32_t size = get(central + 24, 4);
+    const int nameLength = get(central + 28, 2);
+    const std::string name = zip.substr(central + 46, nameLength);
+    const size_t local = get(central + 42, 4);
+    ASSERT_EQ(get(local, 4), 0x04034B50u);
+    const size_t data = local + 30 + get(local + 26, 2) + get(local + 28, 2);
+    ASSERT_LE(data + size + 16, zip.size());
+    const std::string contents = zip.substr(data, size);
+    EXPECT_EQ(Crc32(contents), crc) << name;
+    EXPECT_EQ(get(data + size, 4), 0x08074B50u) << name;
+    EXPECT_EQ(get(data + size + 4, 4), crc) << name;
+    EXPECT_EQ(get(data + size + 8, 4), size) << name;
+    if (name == "3D/3dmodel.model") model = contents;
+    central += 46 + nameLength + get(central + 30, 2) + get(central + 32, 2);
+  }
+  auto count = [&](const std::string& tag) {
+    size_t n = 0;
+    for (size_t pos = model.find(tag); pos != std::string::npos;
+         pos = model.find(tag, pos + 1))
+      ++n;
+    return n;
+  };
+  EXPECT_EQ(count("<vertex "), mesh.vertPos.size());
+  EXPECT_EQ(count("<triangle "), mesh.triVerts.size());
+}
+
+TEST(MeshIO, CompressedGLB) {
+  const Manifold sphere = Manifold::Sphere(1, 128);
+  ExportOptions options;
+  options.faceted = false;
+  ExportMesh("data/sphere.glb", sphere, options);
+  options.quantize = true;
+  options.compress = true;
+  ExportMesh("data/sphereCompressed.glb", sphere, options);
+
+  std::ifstream plain("data/sphere.glb", std::ios::binary | std::ios::ate);
+  std::ifstream compressed("data/sphereCompressed.glb",
+                           std::ios::binary | std::ios::ate);
+  const std::streamoff compressedSize = compressed.tellg();
+  const std::streamoff plainSize = plain.tellg();
+  EXPECT_LT(2 * compressedSize, plainSize);
+
+  // Decode the compressed file and compare it to the mesh.
+  const std::string glb = ReadFile("data/sphereCompressed.glb");
+  ASSERT_GE(glb.size(), 28u);
+  EXPECT_EQ(glb.substr(0, 4), "glTF");
+  uint32_t jsonLength;
+  std::memcpy(&jsonLength, glb.data() + 12, 4);
+  ASSERT_LE(28 + jsonLength, glb.size());
+  const std::string json = glb.substr(20, jsonLength);
+  const std::string bin = glb.substr(28 + jsonLength);
+  EXPECT_NE(json.find("\"extensionsRequired\":[\"KHR_mesh_quantization\","
+                      "\"EXT_meshopt_compression\"]"),
+            std::string::npos);
+
+  // Returns the decoded bufferView of the given accessor.
+  auto decode = [&](int accessor, int& stride, int& count) {
+    size_t pos = json.find("\"bufferViews\":[");
+    for (int i = 0; i <= accessor; ++i)
+      pos = json.find("\"EXT_meshopt_compression\":{", pos + 1);
+    const size_t offset = JsonInt(json, pos, "byteOffset");
+    const size_t length = JsonInt(json, pos, "byteLength");
+    stride = JsonInt(json, pos, "byteStride");
+    count = JsonInt(json, pos, "count");
+    EXPECT_LE(offset + length, bin.size());
+    return bin.substr(offset, length);
+  };
+  size_t pos = 0;
+  const int posAccessor = JsonInt(json, pos, "POSITION");
+  const int normalAccessor = JsonInt(json, pos, "NORMAL");
+  const int indexAccessor = JsonInt(json, pos, "indices");
+  const glm::vec3 translation = JsonVec3(json, "translation");
+  const glm::vec3 scale = JsonVec3(json, "scale");
+
+  const Mesh mesh = sphere.GetMesh();
+  const int numVert = mesh.vertPos.size();
+  int stride, count;
+  std::string encoded = decode(posAccessor, stride, count);
+  ASSERT_EQ(stride, 8);
+  ASSERT_EQ(count, numVert);
+  const std::vector<uint8_t> position = DecodeVertices(encoded, count, stride);
+  for (int i = 0; i < numVert; ++i) {
+    int16_t v[3];
+    std::memcpy(v, position.data() + 8 * i, 6);
+    // Quantized positions are Y-up.
+    const glm::vec3 yUp = translation + scale * glm::vec3(v[0], v[1], v[2]);
+    const glm::vec3 expected = mesh.vertPos[i];
+    ASSERT_NEAR(yUp.x, expected.y, scale.x);
+    ASSERT_NEAR(yUp.y, expected.z, scale.x);
+    ASSERT_NEAR(yUp.z, expected.x, scale.x);
+  }
+
+  encoded = decode(normalAccessor, stride, count);
+  ASSERT_EQ(stride, 4);
+  ASSERT_EQ(count, numVert);
+  const std::vector<uint8_t> normal = DecodeVertices(encoded, count, stride);
+  for (int i = 0; i < numVert; ++i) {
+    // Undo the octahedral filter.
+    const int8_t* n = reinterpret_cast<const int8_t*>(normal.data() + 4 * i);
+    glm::vec3 oct(n[0], n[1], n[2] - glm::abs(n[0]) - glm::abs(n[1]));
+    const float t = glm::max(-oct.z, 0.0f);
+    oct.x -= oct.x >= 0 ? t : -t;
+    oct.y -= oct.y >= 0 ? t : -t;
+    const glm::vec3 yUp = glm::normalize(oct);
+    const glm::vec3 expected = mesh.vertNormal[i];
+    ASSERT_GT(glm::dot(yUp, glm::vec3(expected.y, expected.z, expected.x)),
+              0.999f);
+  }
+
+  encoded = decode(indexAccessor, stride, count);
+  ASSERT_EQ(count, 3 * static_cast<int>(mesh.triVerts.size()));
+  const std::vector<uint32_t> index = DecodeIndices(encoded, count);
+  for (int i = 0; i < count; ++i)
+    ASSERT_EQ(static_cast<int>(index[i]), mesh.triVerts[i / 3][i % 3]);
+}
+
+TEST(Manifold, WeldVertices) {
+  const Mesh cube = Manifold::Cube().GetMesh();
+  Mesh soup;
+  std::mt19937 gen(12345);
+  std::uniform_real_distribution<float> jitter(-1e-5f, 1e-5f);
+  for (const glm::ivec3& tri : cube.triVerts) {
+    const int first = soup.vertPos.size();
+    soup.triVerts.emplace_back(first, first + 1, first + 2);
+    for (int i : {0, 1, 2})
+      soup.vertPos.push_back(cube.vertPos[tri[i]] +
+                             glm::vec3(jitter(gen), jitter(gen), jitter(gen)));
+  }
+
+  Mesh exact = WeldVertices(soup);
+  EXPECT_EQ(exact.vertPos.size(), soup.vertPos.size());
+  EXPECT_EQ(exact.triVerts.size(), 12);
+
+  Mesh welded = WeldVertices(soup, 1e-4f);
+  EXPECT_EQ(welded.vertPos.size(), 8);
+  EXPECT_EQ(welded.triVerts.size(), 12);
+  EXPECT_TRUE(Manifold(welded).IsManifold());
+}
+
+/**
+ * Copies of a vertex that are only within tolerance of each other through a
+ * third copy are still merged.
+ */
+TEST(Manifold, WeldVerticesChain) {
+  const Mesh tet = Manifold::Tetrahedron().GetMesh();
+  const float tolerance = 1e-3f;
+  // Each vertex has three copies: the first two are 1.5 tolerances apart and
+  // the last is halfway between them.
+  const float offset[] = {-0.75f * tolerance, 0.75f * tolerance, 0.0f};
+  std::vector<int> copies(tet.vertPos.size(), 0);
+  Mesh soup;
+  for (const glm::ivec3& tri : tet.triVerts) {
+    const int first = soup.vertPos.size();
+    soup.triVerts.emplace_back(first, first + 1, first + 2);
+    for (int i : {0, 1, 2}) {
+      const float dx = offset[copies[tri[i]]++];
+      soup.vertPos.push_back(tet.vertPos[tri[i]] + glm::vec3(dx, 0, 0));
+    }
+  }
+
+  Mesh welded = WeldVertices(soup, tolerance);
+  EXPECT_EQ(welded.vertPos.size(), 4);
+  EXPECT_EQ(welded.triVerts.size(), 4);
+  EXPECT_TRUE(Manifold(welded).IsManifold());
+}
+
+TEST(Manifold, ReorderForRendering) {
+  const Manifold sphere = Manifold::Sphere(1, 256);
+  const Mesh mesh = sphere.GetMesh();
+  const Mesh reordered = ReorderForRendering(mesh);
+  ASSERT_EQ(reordered.vertPos.size(), mesh.vertPos.size());
+  ASSERT_EQ(reordered.vertNormal.size(), mesh.vertNormal.size());
+  ASSERT_EQ(reordered.triVerts.size(), mesh.triVerts.size());
+
+  // Vertices are numbered in the order they are first used.
+  int nextVert = 0;
+  for (const glm::ivec3& tri : reordered.triVerts)
+    for (int i : {0, 1, 2}) {
+      ASSERT_LE(tri[i], nextVert);
+      if (tri[i] == nextVert) ++nextVert;
+    }
+
+  // Each vertex is transformed at least once, about half a time per triangle.
+  const float acmr = ACMR(reordered);
+  EXPECT_LT(acmr, ACMR(mesh));
+  EXPECT_GE(acmr, 0.5f);
+
+  const Manifold result(reordered);
+  EXPECT_TRUE(result.IsManifold());
+  EXPECT_NEAR(result.GetProperties().volume, sphere.GetProperties().volume,
+              1e-5);
+}
+
 /**
  * This tests that turning a mesh into a manifold and returning it to a mesh
  * produces a consistent result.
@@ -219,6 +672,266 @@ TEST(Manifold, Sphere) {
   EXPECT_EQ(sphere.NumTri(), n * n * 8);
 }
 
+/**
+ * Settings changed inside an ExecutionContext stay there, and its buffers come
+ * from its allocator.
+ */
+TEST(Manifold, ExecutionContext) {
+  struct CountingAllocator : public Allocator {
+    std::atomic<size_t> bytes{0};
+    void* Allocate(size_t size) override {
+      bytes += size;
+      return malloc(size);
+    }
+    void Deallocate(void* ptr, size_t size) override {
+      bytes -= size;
+      free(ptr);
+    }
+  };
+  auto allocator = std::make_shared<CountingAllocator>();
+  const int defaultSegments = Manifold::GetCircularSegments(10);
+
+  ExecutionContext context;
+  context.maxThreads = 2;
+  context.allocator = allocator;
+  context.circularSegments = 12;
+  Manifold sphere;
+  context.Execute([&]() {
+    EXPECT_EQ(Manifold::GetCircularSegments(10), 12);
+    Manifold::SetCircularSegments(16);
+    sphere = Manifold::Sphere(10);
+    sphere.NumTri();
+  });
+  EXPECT_EQ(Manifold::GetCircularSegments(10), defaultSegments);
+  EXPECT_EQ(context.circularSegments, 12);
+  EXPECT_EQ(sphere.NumTri(), Manifold::Sphere(10, 16).NumTri());
+  EXPECT_GT(allocator->bytes, 0);
+
+  sphere = Manifold();
+  EXPECT_EQ(allocator->bytes, 0);
+}
+
+/**
+ * Copies share a buffer until one of them is modified.
+ */
+TEST(Manifold, CopyOnWrite) {
+  VecDH<int> a(1000, 1);
+  VecDH<int> b = a;
+  EXPECT_TRUE(a.IsShared());
+  EXPECT_EQ(a.cptrH(), b.cptrH());
+
+  b[0] = 2;
+  EXPECT_FALSE(a.IsShared());
+  EXPECT_NE(a.cptrH(), b.cptrH());
+  EXPECT_EQ(a[0], 1);
+  EXPECT_EQ(b[0], 2);
+  EXPECT_EQ(b[999], 1);
+
+  const VecDH<int> c = b;
+  EXPECT_EQ(c[0], 2);
+  EXPECT_TRUE(b.IsShared());
+  b.resize(0);
+  EXPECT_EQ(c.size(), 1000);
+  EXPECT_EQ(b.size(), 0);
+
+  Manifold sphere = Manifold::Sphere(1, 64);
+  Manifold warped = sphere.Warp([](glm::vec3& v) { v.z *= 2; });
+  EXPECT_EQ(warped.NumTri(), sphere.NumTri());
+  EXPECT_NEAR(sphere.BoundingBox().Size().z, 2, 1e-5);
+  EXPECT_NEAR(warped.BoundingBox().Size().z, 4, 1e-5);
+}
+
+#ifndef NDEBUG
+/**
+ * A write through a pointer taken before a copy would change both copies, so
+ * in debug builds the next mutable access throws.
+ */
+TEST(Manifold, CopyOnWriteStalePointer) {
+  VecDH<int> a(1000, 1);
+  int* stale = a.ptrH();
+  const VecDH<int> b = a;
+  stale[0] = 2;
+  EXPECT_THROW(a[1] = 3, logicErr);
+}
+#endif
+
+/**
+ * Buffers report their bytes to the context's MemoryUsage, by phase, and
+ * allocations beyond its budget throw.
+ */
+TEST(Manifold, MemoryUsage) {
+  ExecutionContext context;
+  context.memory = std::make_shared<MemoryUsage>();
+  context.Execute([]() {
+    Manifold sphere = Manifold::Sphere(1, 64);
+    Manifold cube = Manifold::Cube(glm::vec3(1.0f));
+    (sphere - cube).NumTri();
+  });
+  const MemoryUsage& memory = *context.memory;
+  EXPECT_EQ(memory.Current(), 0);
+  EXPECT_GT(memory.Peak(), 0);
+  const auto bySite = memory.BySite();
+  ASSERT_EQ(bySite.count("Boolean3"), 1);
+  EXPECT_GT(bySite.at("Boolean3").peak, 0);
+  EXPECT_LE(bySite.at("Boolean3").peak, memory.Peak());
+  EXPECT_GE(bySite.at("Boolean3").total, bySite.at("Boolean3").peak);
+
+  context.memory = std::make_shared<MemoryUsage>(1 << 16);
+  context.Execute([]() {
+    EXPECT_THROW(Manifold::Sphere(1, 256).NumTri(), memoryErr);
+  });
+  EXPECT_EQ(context.memory->Current(), 0);
+  EXPECT_LE(context.memory->Peak(), 1 << 16);
+}
+
+/**
+ * Calibrated policy thresholds are written to the cache file and read back
+ * from it.
+ */
+TEST(Manifold, PolicyCache) {
+  const std::string cacheFile =
+      ::testing::TempDir() + "manifold_policy_cache_test.txt";
+  std::remove(cacheFile.c_str());
+  const PolicyThresholds calibrated = LoadPolicy(cacheFile, 1 << 10);
+  for (int i = 0; i < kNumOpKind; ++i) {
+    EXPECT_GT(calibrated.seq[i], 0);
+  }
+
+  // Replace the thresholds, keeping the header written for this machine, to
+  // check that they are read back rather than calibrated again.
+  std::ifstream in(cacheFile);
+  std::string header;
+  ASSERT_TRUE(std::getline(in, header));
+  in.close();
+  std::ofstream out(cacheFile);
+  out << header << std::endl << "11 12 13 14 15" << std::endl;
+  out.close();
+  const PolicyThresholds cached = LoadPolicy(cacheFile, 1 << 10);
+  for (int i = 0; i < kNumOpKind; ++i) {
+    EXPECT_EQ(cached.seq[i], 11 + i);
+  }
+  EXPECT_EQ(cached.par, 15);
+  std::remove(cacheFile.c_str());
+}
+
+/**
+ * A trace holds the phases of the operations run while it was started.
+ */
+TEST(Manifold, Trace) {
+  const std::string traceFile = ::testing::TempDir() + "trace_test.json";
+  Manifold sphere = Manifold::Sphere(1, 16);
+  Manifold cube = Manifold::Cube(glm::vec3(1.0f));
+  StartTrace(traceFile);
+  EXPECT_TRUE(TraceEnabled());
+  (sphere - cube).NumTri();
+  StopTrace();
+  EXPECT_FALSE(TraceEnabled());
+  (sphere + cube).NumTri();
+
+  std::ifstream in(traceFile);
+  const std::string trace((std::istreambuf_iterator<char>(in)),
+                          std::istreambuf_iterator<char>());
+  EXPECT_EQ(trace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), 0);
+  const std::string boolean = "\"name\":\"Boolean3\"";
+  const size_t first = trace.find(boolean);
+  EXPECT_NE(first, std::string::npos);
+  EXPECT_EQ(trace.find(boolean, first + 1), std::string::npos);
+  EXPECT_NE(trace.find("\"name\":\"Result triangulation\""),
+            std::string::npos);
+  EXPECT_NE(trace.find("\"name\":\"BatchUnion\""), std::string::npos);
+  in.close();
+  std::remove(traceFile.c_str());
+}
+
+/**
+ * Strided buffers of doubles and 16-bit indices give the same Manifold as the
+ * equivalent Mesh.
+ */
+TEST(Manifold, MeshView) {
+  const Mesh mesh = Manifold::Sphere(1, 16).GetMesh();
+  const Manifold expected(mesh);
+
+  // interleaved with another attribute, as in a typical vertex buffer
+  std::vector<double> vertices;
+  for (const glm::vec3& v : mesh.vertPos) {
+    vertices.insert(vertices.end(), {v.x, v.y, v.z, 1.0});
+  }
+  std::vector<uint16_t> tris;
+  for (const glm::ivec3& tri : mesh.triVerts) {
+    tris.insert(tris.end(), {static_cast<uint16_t>(tri[0]),
+                             static_cast<uint16_t>(tri[1]),
+                             static_cast<uint16_t>(tri[2])});
+  }
+  MeshView view;
+  view.vertPos = vertices.data();
+  view.numVert = mesh.vertPos.size();
+  view.vertStride = 4 * sizeof(double);
+  view.doublePositions = true;
+  view.triVerts = tris.data();
+  view.numTri = mesh.triVerts.size();
+  view.indexBytes = 2;
+  const Manifold manifold(view);
+  EXPECT_TRUE(manifold.IsManifold());
+  EXPECT_EQ(manifold.NumVert(), expected.NumVert());
+  EXPECT_EQ(manifold.NumTri(), expected.NumTri());
+  EXPECT_NEAR(manifold.GetProperties().volume, expected.GetProperties().volume,
+              1e-5);
+
+  // unaligned, as in a packed file buffer
+  std::vector<char> packed(1 + vertices.size() * sizeof(double));
+  std::memcpy(packed.data() + 1, vertices.data(),
+              vertices.size() * sizeof(double));
+  view.vertPos = packed.data() + 1;
+  EXPECT_EQ(Manifold(view).NumTri(), expected.NumTri());
+
+  tris[4] = mesh.vertPos.size();
+  EXPECT_THROW(Manifold{view}, userErr);
+
+  view.indexBytes = 3;
+  EXPECT_THROW(Manifold{view}, userErr);
+}
+
+/**
+ * Writing into interleaved caller buffers gives the same data as GetMesh().
+ */
+TEST(Manifold, GetMeshBuffers) {
+  const Manifold sphere = Manifold::Sphere(1, 16);
+  const Mesh mesh = sphere.GetMesh();
+  const int numVert = sphere.NumVert();
+  const int numTri = sphere.NumTri();
+
+  std::vector<float> vertices(6 * numVert);
+  std::vector<uint16_t> tris(3 * numTri);
+  MeshBuffers buffers;
+  buffers.vertPos = vertices.data();
+  buffers.vertStride = 6 * sizeof(float);
+  buffers.vertNormal = vertices.data() + 3;
+  buffers.normalStride = 6 * sizeof(float);
+  buffers.triVerts = tris.data();
+  buffers.indexBytes = 2;
+  sphere.GetMesh(buffers);
+
+  for (int i = 0; i < numVert; ++i) {
+    for (int j : {0, 1, 2}) {
+      EXPECT_EQ(vertices[6 * i + j], mesh.vertPos[i][j]);
+      EXPECT_EQ(vertices[6 * i + 3 + j], mesh.vertNormal[i][j]);
+    }
+  }
+  for (int i = 0; i < numTri; ++i) {
+    for (int j : {0, 1, 2}) EXPECT_EQ(tris[3 * i + j], mesh.triVerts[i][j]);
+  }
+
+  // unaligned, as in a packed file buffer
+  std::vector<char> packed(1 + 3 * numVert * sizeof(float));
+  MeshBuffers packedBuffers;
+  packedBuffers.vertPos = packed.data() + 1;
+  sphere.GetMesh(packedBuffers);
+  std::memcpy(vertices.data(), packed.data() + 1, 3 * numVert * sizeof(float));
+  for (int i = 0; i < numVert; ++i) {
+    for (int j : {0, 1, 2}) EXPECT_EQ(vertices[3 * i + j], mesh.vertPos[i][j]);
+  }
+}
+
 TEST(Manifold, Normals) {
   Mesh cube = Manifold::Cube(glm::vec3(1), true).GetMesh();
   const int nVert = cube.vertPos.size();
@@ -370,6 +1083,80 @@ TEST(Manifold, Csaszar) {
   }
 }
 
+/**
+ * Compose grafts the colliders of its parts rather than building a new one,
+ * which must find exactly the same overlaps.
+ */
+TEST(Manifold, ComposeCollider) {
+  Manifold sphere = Manifold::Sphere(1, 20);
+  std::vector<Manifold> parts;
+  for (int i = 0; i < 5; ++i) {
+    parts.push_back(sphere.Rotate(0, 0, 15 * i).Translate({3.0f * i, 0, 0}));
+  }
+  Manifold composed = Manifold::Compose(parts);
+  Manifold rebuilt(composed.GetMesh());
+  EXPECT_EQ(composed.NumSelfIntersections(), 0);
+
+  Manifold tool =
+      Manifold::Cube({14, 0.5, 0.5}, true).Translate({6, 0.2, 0.1});
+  EXPECT_EQ(composed.NumOverlaps(tool), rebuilt.NumOverlaps(tool));
+  EXPECT_NEAR((composed - tool).GetProperties().volume,
+              (rebuilt - tool).GetProperties().volume, 1e-5);
+}
+
+/**
+ * Each Compose of an already composed part grafts another level on top, so a
+ * long chain of them must fall back to rebuilding before the tree gets too deep
+ * to traverse.
+ */
+TEST(Manifold, ComposeColliderDepth) {
+  const Manifold cube = Manifold::Cube();
+  Manifold chain = cube;
+  for (int i = 1; i < 100; ++i) {
+    chain = Manifold::Compose({chain, cube.Translate({2.0f * i, 0, 0})});
+    EXPECT_EQ(chain.NumTri(), 12 * (i + 1));
+  }
+  Manifold rebuilt(chain.GetMesh());
+  EXPECT_EQ(chain.NumSelfIntersections(), 0);
+
+  Manifold tool = Manifold::Cube({200, 0.5, 0.5}).Translate({-0.5, 0.2, 0.2});
+  EXPECT_EQ(chain.NumOverlaps(tool), rebuilt.NumOverlaps(tool));
+  EXPECT_NEAR((chain - tool).GetProperties().volume,
+              (rebuilt - tool).GetProperties().volume, 1e-3);
+}
+
+/**
+ * Compose keeps its inputs as instances sharing their geometry, and Booleans
+ * only materialize the instances they cut.
+ */
+TEST(Manifold, Instances) {
+  Manifold cube = Manifold::Cube(glm::vec3(1.0f), true);
+  std::vector<Manifold> parts;
+  for (int i = 0; i < 10; ++i) {
+    parts.push_back(cube.Translate({2.0f * i, 0, 0}));
+  }
+  Manifold plate = Manifold::Compose(parts).Rotate(0, 0, 90);
+  Box box = plate.BoundingBox();
+  EXPECT_NEAR(box.min.x, -0.5, 1e-5);
+  EXPECT_NEAR(box.max.x, 0.5, 1e-5);
+  EXPECT_NEAR(box.min.y, -0.5, 1e-5);
+  EXPECT_NEAR(box.max.y, 18.5, 1e-5);
+  EXPECT_EQ(plate.Decompose().size(), 10);
+
+  Manifold tool = cube.Translate({0.5, 0.5, 0.5});
+  Manifold cut = plate - tool;
+  EXPECT_EQ(cut.Decompose().size(), 10);
+  EXPECT_NEAR(cut.GetProperties().volume, 9.875, 1e-5);
+  Manifold flat =
+      Manifold(Manifold::Compose(parts).GetMesh()).Rotate(0, 0, 90) - tool;
+  EXPECT_EQ(cut.NumTri(), flat.NumTri());
+  EXPECT_NEAR(cut.GetProperties().volume, flat.GetProperties().volume, 1e-5);
+
+  box = cube.Rotate(0, 0, 45).BoundingBox();
+  EXPECT_NEAR(box.max.x, glm::sqrt(0.5f), 1e-5);
+  EXPECT_NEAR(box.max.y, glm::sqrt(0.5f), 1e-5);
+}
+
 /**
  * These tests verify the calculation of a manifold's geometric properties.
  */
@@ -423,6 +1210,75 @@ TEST(Manifold, GetCurvature) {
   }
 }
 
+TEST(Manifold, SelfIntersections) {
+  Manifold sphere = Manifold::Sphere(1, 20);
+  EXPECT_EQ(sphere.NumSelfIntersections(), 0);
+
+  Manifold apart = Manifold::Compose({sphere, sphere.Translate({3, 0, 0})});
+  EXPECT_EQ(apart.NumSelfIntersections(), 0);
+
+  Manifold overlap = Manifold::Compose({sphere, sphere.Translate({1, 0, 0})});
+  const int numIntersections = overlap.NumSelfIntersections();
+  EXPECT_GT(numIntersections, 0);
+  const auto pairs = overlap.SelfIntersectingPairs();
+  EXPECT_EQ(pairs.size(), numIntersections);
+  for (const auto& pair : pairs) {
+    EXPECT_LT(pair.first, pair.second);
+    EXPECT_LT(pair.second, overlap.NumTri());
+  }
+}
+
+/**
+ * Two tetrahedra joined only at their apex, one rotated through the other:
+ * every crossing pair of triangles shares that vertex, but not an edge.
+ */
+TEST(Manifold, SelfIntersectionsSharedVertex) {
+  Mesh mesh;
+  mesh.vertPos = {{0, 0, 0},
+                  {1, 0, 0},
+                  {0, 1, 0},
+                  {0, 0, 1},
+                  {2 / 3.0f, 2 / 3.0f, -1 / 3.0f},
+                  {-1 / 3.0f, 2 / 3.0f, 2 / 3.0f},
+                  {2 / 3.0f, -1 / 3.0f, 2 / 3.0f}};
+  for (int offset : {0, 3}) {
+    const int a = 1 + offset, b = 2 + offset, c = 3 + offset;
+    mesh.triVerts.push_back({0, b, a});
+    mesh.triVerts.push_back({0, a, c});
+    mesh.triVerts.push_back({0, c, b});
+    mesh.triVerts.push_back({a, b, c});
+  }
+  Manifold pinched(mesh);
+  EXPECT_TRUE(pinched.IsManifold());
+  EXPECT_GT(pinched.NumSelfIntersections(), 0);
+}
+
+TEST(Manifold, Interferences) {
+  Manifold sphere = Manifold::Sphere(1, 20);
+  Manifold small = sphere.Scale(glm::vec3(0.5f));
+  std::vector<Manifold> parts;
+  parts.push_back(sphere.Translate({5, 0, 0}));
+  parts.push_back(sphere);
+  parts.push_back(sphere.Translate({1.5, 0, 0}));
+  parts.push_back(sphere.Translate({0, 5, 0}));
+  parts.push_back(small.Translate({5, 0, 0}));
+  parts.push_back(Manifold::Cube(glm::vec3(1.0f), true).Translate({0, 6.5, 0}));
+
+  std::vector<Interference> interferences = Manifold::Interferences(parts);
+  ASSERT_EQ(interferences.size(), 2);
+  EXPECT_EQ(interferences[0].first, 0);
+  EXPECT_EQ(interferences[0].second, 4);
+  EXPECT_TRUE(std::isnan(interferences[0].volume));
+  EXPECT_EQ(interferences[1].first, 1);
+  EXPECT_EQ(interferences[1].second, 2);
+
+  interferences = Manifold::Interferences(parts, true);
+  ASSERT_EQ(interferences.size(), 2);
+  EXPECT_NEAR(interferences[0].volume, small.GetProperties().volume, 1e-5);
+  EXPECT_GT(interferences[1].volume, 0);
+  EXPECT_LT(interferences[1].volume, sphere.GetProperties().volume);
+}
+
 /**
  * Testing more advanced Manifold operations.
  */
@@ -636,6 +1492,293 @@ TEST(Boolean, SplitByPlane60) {
               splits.second.GetProperties().volume, 1e-5);
 }
 
+/**
+ * Booleans of transformed operands are carried out in the frame of the larger
+ * one, which must match applying both transforms first.
+ */
+TEST(Boolean, TransformedOperands) {
+  Manifold sphere =
+      Manifold::Sphere(1, 32).Rotate(20, 30, 40).Translate({1, 2, 3});
+  Manifold cube = Manifold::Cube(glm::vec3(1.0f), true)
+                      .Rotate(-10, 50, 5)
+                      .Translate({1.5, 2, 3});
+  Manifold lazy = sphere - cube;
+  EXPECT_TRUE(lazy.IsManifold());
+  EXPECT_TRUE(lazy.MatchesTriNormals());
+  const Properties lazyProp = lazy.GetProperties();
+
+  Manifold applied = Manifold(sphere.GetMesh()) - Manifold(cube.GetMesh());
+  const Properties appliedProp = applied.GetProperties();
+  EXPECT_NEAR(lazyProp.volume, appliedProp.volume, 1e-4);
+  EXPECT_NEAR(lazyProp.surfaceArea, appliedProp.surfaceArea, 1e-4);
+}
+
+/**
+ * A singular transform on the larger operand has no inverse to move the other
+ * into its frame, so both are moved to world space instead.
+ */
+TEST(Boolean, SingularTransform) {
+  Manifold cube = Manifold::Cube(glm::vec3(1.0f), true);
+  Manifold flat = Manifold::Sphere(1, 32).Scale({0, 1, 1});
+  const float volume = (cube - flat).GetProperties().volume;
+  EXPECT_FALSE(std::isnan(volume));
+  EXPECT_NEAR(volume, 1, 1e-4);
+}
+
+TEST(Boolean, BatchBoolean) {
+  std::vector<Manifold> cubes;
+  for (int i = 0; i < 4; ++i)
+    cubes.push_back(Manifold::Cube().Translate({0.5f * i, 0, 0}));
+  Manifold sum = cubes[0];
+  for (int i = 1; i < 4; ++i) sum += cubes[i];
+  const Manifold batchSum =
+      Manifold::BatchBoolean(cubes, Manifold::OpType::ADD);
+  EXPECT_TRUE(batchSum.IsManifold());
+  EXPECT_NEAR(batchSum.GetProperties().volume, sum.GetProperties().volume,
+              1e-5);
+  EXPECT_NEAR(batchSum.GetProperties().volume, 2.5, 1e-5);
+
+  const Manifold batchDifference =
+      Manifold::BatchBoolean(cubes, Manifold::OpType::SUBTRACT);
+  EXPECT_TRUE(batchDifference.IsManifold());
+  EXPECT_NEAR(batchDifference.GetProperties().volume, 0.5, 1e-5);
+
+  EXPECT_TRUE(
+      Manifold::BatchBoolean({}, Manifold::OpType::INTERSECT).IsEmpty());
+
+  // Operands whose boxes are disjoint are composed, not passed to Boolean3,
+  // and a difference subtracts the union of the rest in one Boolean.
+  std::vector<Manifold> apart;
+  for (int i = 0; i < 4; ++i)
+    apart.push_back(Manifold::Cube().Translate({2.0f * i, 0, 0}));
+  const Manifold composed =
+      Manifold::BatchBoolean(apart, Manifold::OpType::ADD);
+  EXPECT_NEAR(composed.GetProperties().volume, 4, 1e-5);
+  EXPECT_TRUE(composed.GetBooleanStats().empty());
+
+  apart.insert(apart.begin(),
+               Manifold::Cube({8, 2, 2}).Translate({-0.5f, -0.5f, -0.5f}));
+  const Manifold carved =
+      Manifold::BatchBoolean(apart, Manifold::OpType::SUBTRACT);
+  EXPECT_NEAR(carved.GetProperties().volume, 32 - 4, 1e-4);
+  EXPECT_EQ(carved.GetBooleanStats().size(), 1);
+}
+
+/**
+ * A serialized CSG tree evaluates to the same result elsewhere, and a receiver
+ * that caches leaves by hash needs each of them sent only once.
+ */
+TEST(Boolean, Serialize) {
+  Manifold sphere = Manifold::Sphere(1, 32);
+  Manifold cube = Manifold::Cube(glm::vec3(1.0f));
+  Manifold tree = (sphere - cube.Rotate(10, 20, 30)).Translate({1, 0, 0}) +
+                  cube.Translate({-1, 0, 0});
+
+  std::unordered_set<uint64_t> sent;
+  auto embedLeaf = [&sent](uint64_t hash) { return sent.insert(hash).second; };
+  std::unordered_map<uint64_t, Manifold> cache;
+  const std::string first = tree.Serialize(embedLeaf);
+  Manifold remote = Manifold::Deserialize(first, &cache);
+  EXPECT_EQ(cache.size(), 2);
+
+  const std::string second = tree.Serialize(embedLeaf);
+  EXPECT_LT(second.size(), first.size() / 10);
+  EXPECT_THROW(Manifold::Deserialize(second), userErr);
+  Manifold again = Manifold::Deserialize(second, &cache);
+
+  // the worker returns only the evaluated result
+  Manifold result = Manifold::Deserialize(remote.Serialize());
+  EXPECT_TRUE(result.IsManifold());
+  EXPECT_EQ(result.NumTri(), tree.NumTri());
+  EXPECT_NEAR(result.GetProperties().volume, tree.GetProperties().volume,
+              1e-5);
+  EXPECT_NEAR(again.GetProperties().volume, tree.GetProperties().volume,
+              1e-5);
+
+  // A long chain of unions is written as one node.
+  Manifold sum = cube;
+  for (int i = 1; i < 2000; ++i) sum += cube.Translate({2.0f * i, 0, 0});
+  const Manifold chain = Manifold::Deserialize(sum.Serialize());
+  EXPECT_EQ(chain.NumTri(), 2000 * cube.NumTri());
+}
+
+/**
+ * Deserialize() applies a leaf's precision before simplifying it, and rejects
+ * leaves with bad indices, empty nodes and trees nested too deeply.
+ */
+TEST(Boolean, SerializeLeaf) {
+  // A tetrahedron with a vertex on an edge, close to one end.
+  Mesh mesh;
+  mesh.vertPos = {{-1, -1, 1}, {-1, 1, -1}, {1, -1, -1}, {1, 1, 1}};
+  mesh.vertPos.push_back(glm::mix(mesh.vertPos[0], mesh.vertPos[1], 0.005f));
+  mesh.triVerts = {{2, 0, 4}, {2, 4, 1}, {3, 1, 4},
+                   {3, 4, 0}, {2, 3, 0}, {3, 2, 1}};
+  const Manifold split(mesh);
+  ASSERT_EQ(split.NumTri(), 6);
+  std::string data = split.Serialize();
+
+  // The root leaf's hash and blob follow the magic, version, tag and
+  // transform.
+  const size_t hashOffset = 12 + sizeof(glm::mat4x3);
+  const size_t blob = hashOffset + sizeof(uint64_t);
+  auto setField = [&](size_t offset, auto value) {
+    std::memcpy(&data[offset], &value, sizeof(value));
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = hashOffset + sizeof(hash); i < data.size(); ++i)
+      hash = (hash ^ static_cast<unsigned char>(data[i])) * 1099511628211ull;
+    std::memcpy(&data[hashOffset], &hash, sizeof(hash));
+  };
+
+  setField(blob, 0.1f);
+  const Manifold coarse = Manifold::Deserialize(data);
+  EXPECT_GE(coarse.Precision(), 0.1f);
+  EXPECT_EQ(coarse.NumTri(), 4);
+
+  const size_t firstIndex = blob + 12 + sizeof(glm::vec3) * split.NumVert();
+  setField(firstIndex, uint32_t(split.NumVert()));
+  EXPECT_THROW(Manifold::Deserialize(data), userErr);
+  setField(firstIndex, std::numeric_limits<uint32_t>::max());
+  EXPECT_THROW(Manifold::Deserialize(data), userErr);
+
+  // A chain of single-child unions, deeper than the reader allows.
+  std::string deep = data.substr(0, 8);
+  const uint32_t tagUnion = 3;
+  const glm::mat4x3 identity(1.0f);
+  const uint32_t count = 1;
+  for (int i = 0; i < 2000; ++i) {
+    deep.append(reinterpret_cast<const char*>(&tagUnion), sizeof(tagUnion));
+    deep.append(reinterpret_cast<const char*>(&identity), sizeof(identity));
+    deep.append(reinterpret_cast<const char*>(&count), sizeof(count));
+  }
+  deep.append(data.substr(8));
+  EXPECT_THROW(Manifold::Deserialize(deep), userErr);
+
+  // A union without children.
+  const size_t unionSize = 2 * sizeof(uint32_t) + sizeof(identity);
+  std::string empty = deep.substr(0, 8 + unionSize);
+  const uint32_t zero = 0;
+  std::memcpy(&empty[empty.size() - sizeof(zero)], &zero, sizeof(zero));
+  EXPECT_THROW(Manifold::Deserialize(empty), userErr);
+}
+
+/**
+ * Each Boolean reports its sizes and timings both on the result and through
+ * the context's callback.
+ */
+TEST(Boolean, Stats) {
+  Manifold sphere = Manifold::Sphere(1, 32);
+  Manifold cube = Manifold::Cube(glm::vec3(1.0f));
+  Manifold result = sphere - cube;
+  std::vector<BooleanStats> stats = result.GetBooleanStats();
+  ASSERT_EQ(stats.size(), 1);
+  EXPECT_EQ(stats[0].numTriP, sphere.NumTri());
+  EXPECT_EQ(stats[0].numTriQ, cube.NumTri());
+  EXPECT_EQ(stats[0].numTri, result.NumTri());
+  EXPECT_GT(stats[0].p1q2, 0);
+  EXPECT_GT(stats[0].x12, 0);
+  EXPECT_GT(stats[0].tempBytesEstimate, 0);
+  EXPECT_GE(stats[0].triangulation, 0.0f);
+
+  int numCalls = 0;
+  ExecutionContext context;
+  context.onBoolean = [&numCalls](const BooleanStats&) { ++numCalls; };
+  context.Execute([&]() {
+    Manifold cylinder = Manifold::Cylinder(2, 0.5f).Translate({0, 0, -1});
+    result = (sphere - cube).Translate({0.1f, 0, 0}) + cylinder;
+    EXPECT_EQ(result.GetBooleanStats().size(), 2);
+  });
+  EXPECT_EQ(numCalls, 2);
+}
+
+#ifndef __EMSCRIPTEN__
+/**
+ * An asynchronous evaluation gives the same result as a blocking one, and a
+ * canceled one can be resumed.
+ */
+TEST(Boolean, EvaluateAsync) {
+  Manifold sphere = Manifold::Sphere(1, 32);
+  Manifold cube = Manifold::Cube(glm::vec3(1.0f));
+  Manifold cylinder = Manifold::Cylinder(2, 0.5f).Translate({0, 0, -1});
+  Manifold result = (sphere - cube) + cylinder;
+
+  ExecutionContext context;
+  context.progress = std::make_shared<Progress>();
+  context.progress->Cancel();
+  context.Execute([&]() { EXPECT_THROW(result.NumTri(), canceledErr); });
+
+  ManifoldFuture future = result.EvaluateAsync();
+  EXPECT_TRUE(future.WaitFor(60));
+  EXPECT_TRUE(future.Ready());
+  EXPECT_FLOAT_EQ(future.GetProgress(), 1.0f);
+  Manifold evaluated = future.Get();
+
+  Manifold blocking = (sphere - cube) + cylinder;
+  EXPECT_EQ(evaluated.NumTri(), blocking.NumTri());
+  EXPECT_EQ(result.NumTri(), blocking.NumTri());
+  EXPECT_NEAR(evaluated.GetProperties().volume,
+              blocking.GetProperties().volume, 1e-5);
+
+  // Assigning over a running evaluation cancels it, and a moved-from handle
+  // has nothing to report or cancel.
+  Manifold large = Manifold::Sphere(1, 256) - Manifold::Cube(glm::vec3(1.0f));
+  future = large.EvaluateAsync();
+  future = ((sphere - cube) + cylinder).EvaluateAsync();
+  ManifoldFuture moved = std::move(future);
+  EXPECT_FLOAT_EQ(future.GetProgress(), 0.0f);
+  future.Cancel();
+  EXPECT_EQ(moved.Get().NumTri(), blocking.NumTri());
+  EXPECT_GT(large.NumTri(), 0);
+}
+
+/**
+ * Many threads querying one shared, unevaluated Manifold must all see the
+ * result of a single evaluation.
+ */
+TEST(Boolean, ConcurrentEvaluation) {
+  auto makeTree = []() {
+    Manifold sphere = Manifold::Sphere(1, 32);
+    Manifold cube = Manifold::Cube(glm::vec3(1.0f)).Rotate(10, 20, 30);
+    return (sphere - cube).Translate({1, 0, 0}) ^
+           Manifold::Cylinder(2, 0.8f, -1, 32).Translate({1, 0, -1});
+  };
+  const Manifold shared = makeTree();
+  const Manifold serial = makeTree();
+  const int numTri = serial.NumTri();
+  const float volume = serial.GetProperties().volume;
+
+  constexpr int kNumThreads = 8;
+  std::vector<int> numTris(kNumThreads);
+  std::vector<float> volumes(kNumThreads);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&, i]() {
+      numTris[i] = shared.NumTri();
+      volumes[i] = shared.Translate({0, 0, 1}).GetProperties().volume;
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  for (int i = 0; i < kNumThreads; ++i) {
+    EXPECT_EQ(numTris[i], numTri);
+    EXPECT_NEAR(volumes[i], volume, 1e-4);
+  }
+}
+
+/**
+ * Transforming a Manifold that is being evaluated does not wait for it, and
+ * describes the same solid.
+ */
+TEST(Boolean, TransformDuringEvaluation) {
+  Manifold result =
+      Manifold::Sphere(1, 128) - Manifold::Cube(glm::vec3(1.0f));
+  ManifoldFuture future = result.EvaluateAsync();
+  Manifold moved = result.Translate({1, 0, 0});
+  const float volume = future.Get().GetProperties().volume;
+  EXPECT_NEAR(moved.GetProperties().volume, volume, 1e-4);
+  EXPECT_NEAR(moved.BoundingBox().min.x, 0, 1e-4);
+}
+#endif
+
 /**
  * This tests that non-intersecting geometry is properly retained.
  */
@@ -0,0 +1,176 @@
+"""Tests of the pymanifold binding, run from CI with
+
+  python3 -m unittest discover -s test/python -p '*_test.py'
+"""
+import os
+import tempfile
+import threading
+import unittest
+
+import numpy as np
+
+from pymanifold import Manifold
+
+
+def triangles(verts, tris):
+    """The triangles as sorted position tuples, each starting from its least
+    corner, which is independent of vertex and triangle order."""
+    result = []
+    for tri in tris:
+        corners = [tuple(float(x) for x in verts[i]) for i in tri]
+        first = corners.index(min(corners))
+        result.append(tuple(corners[first:] + corners[:first]))
+    return sorted(result)
+
+
+def volume(manifold):
+    verts, tris = manifold.to_arrays()
+    a, b, c = (verts[tris[:, i]].astype(np.float64) for i in range(3))
+    return np.einsum('ij,ij', a, np.cross(b, c)) / 6
+
+
+class FromArraysTest(unittest.TestCase):
+
+    def setUp(self):
+        self.verts, self.tris = Manifold.cube(1, 2, 3).to_arrays()
+        self.expected = triangles(self.verts, self.tris)
+
+    def check(self, verts, tris):
+        result_verts, result_tris = Manifold.from_arrays(verts,
+                                                         tris).to_arrays()
+        self.assertEqual(result_verts.dtype, np.float32)
+        self.assertEqual(result_tris.dtype, np.int32)
+        self.assertEqual(result_verts.shape, self.verts.shape)
+        self.assertEqual(result_tris.shape, self.tris.shape)
+        self.assertEqual(triangles(result_verts, result_tris), self.expected)
+
+    def test_round_trip(self):
+        self.assertEqual(self.verts.dtype, np.float32)
+        self.assertEqual(self.tris.dtype, np.int32)
+        self.check(self.verts, self.tris)
+
+    def test_float64(self):
+        self.check(self.verts.astype(np.float64), self.tris)
+
+    def test_strided_views(self):
+        verts = np.zeros((len(self.verts), 5), np.float32)
+        verts[:, 1:4] = self.verts
+        tris = np.zeros((len(self.tris), 4), np.int32)
+        tris[:, :3] = self.tris
+        self.check(verts[:, 1:4], tris[:, :3])
+        verts = np.zeros((len(self.verts), 4), np.float64)
+        verts[:, :3] = self.verts
+        self.check(verts[:, :3], tris[:, :3])
+
+    def test_converted_types(self):
+        self.check(self.verts, self.tris.astype(np.uint16))
+        self.check(self.verts, self.tris.astype(np.uint32))
+        self.check(self.verts, self.tris.astype(np.int64))
+        # Not row-packed, so copied first.
+        self.check(np.asfortranarray(self.verts), np.asfortranarray(self.tris))
+
+    def test_out_of_range(self):
+        num_vert = len(self.verts)
+        tris = self.tris.astype(np.int64)
+        tris[0, 0] += 2**32
+        with self.assertRaises(IndexError):
+            Manifold.from_arrays(self.verts, tris)
+        tris = self.tris.astype(np.int64)
+        tris[0, 0] = -1
+        with self.assertRaises(IndexError):
+            Manifold.from_arrays(self.verts, tris)
+        tris = self.tris.copy()
+        tris[0, 0] = num_vert
+        with self.assertRaises(RuntimeError):
+            Manifold.from_arrays(self.verts, tris)
+
+    def test_bad_shape(self):
+        with self.assertRaises(RuntimeError):
+            Manifold.from_arrays(self.verts[:, :2], self.tris)
+        with self.assertRaises(RuntimeError):
+            Manifold.from_arrays(self.verts, self.tris.reshape(-1))
+
+
+class BatchTest(unittest.TestCase):
+
+    def setUp(self):
+        self.cubes = [Manifold.cube(1, 1, 1).translate(2 * i, 0, 0)
+                      for i in range(3)]
+
+    def test_batch_union(self):
+        batch = Manifold.batch_union(self.cubes)
+        serial = self.cubes[0] + self.cubes[1] + self.cubes[2]
+        self.assertEqual(batch.num_tri(), serial.num_tri())
+        self.assertAlmostEqual(volume(batch), 3, places=5)
+
+    def test_compose(self):
+        composed = Manifold.compose(self.cubes)
+        self.assertEqual(composed.num_vert(), 24)
+        self.assertEqual(composed.num_tri(), 36)
+        self.assertAlmostEqual(volume(composed), 3, places=5)
+
+    def test_batch_difference(self):
+        block = Manifold.cube(6, 2, 2).translate(-0.5, -0.5, -0.5)
+        batch = Manifold.batch_difference([block] + self.cubes)
+        serial = block - self.cubes[0] - self.cubes[1] - self.cubes[2]
+        self.assertAlmostEqual(volume(batch), volume(serial), places=4)
+        self.assertAlmostEqual(volume(batch), 24 - 3, places=4)
+        self.assertEqual(Manifold.batch_difference([block]).num_tri(),
+                         block.num_tri())
+
+
+class ReleasesGilTest(unittest.TestCase):
+
+    def run_threads(self, func):
+        errors = []
+
+        def task():
+            try:
+                func()
+            except Exception as error:  # reported on the main thread
+                errors.append(error)
+        threads = [threading.Thread(target=task) for _ in range(4)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join(60)
+            self.assertFalse(thread.is_alive())
+        if errors:
+            raise errors[0]
+
+    def test_warp(self):
+        sphere = Manifold.sphere(1, 64)
+
+        def warp():
+            moved = sphere.warp(lambda v: (v[0] + 1, v[1], 2 * v[2]))
+            verts, _ = moved.to_arrays()
+            self.assertAlmostEqual(float(verts[:, 0].min()), 0, places=5)
+            self.assertAlmostEqual(float(verts[:, 2].max()), 2, places=5)
+        self.run_threads(warp)
+
+    def test_warp_raises(self):
+        def fail(v):
+            raise ValueError('warp')
+        with self.assertRaises(ValueError):
+            Manifold.cube(1, 1, 1).warp(fail)
+
+    def test_serialize(self):
+        model = Manifold.sphere(1, 32) - Manifold.cube(1, 1, 1)
+
+        def round_trip():
+            data = model.serialize()
+            self.assertIsInstance(data, bytes)
+            result = Manifold.deserialize(data)
+            self.assertEqual(result.num_tri(), model.num_tri())
+        self.run_threads(round_trip)
+
+    def test_export(self):
+        with tempfile.TemporaryDirectory() as directory:
+            filename = os.path.join(directory, 'sphere.glb')
+            Manifold.sphere(1, 32).export(filename)
+            with open(filename, 'rb') as file:
+                self.assertEqual(file.read(4), b'glTF')
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -10,6 +10,12 @@ brick_length = (7 + 5/8) * INCHES
 
 mortar_gap = (3/8) * INCHES
 
+SCALES = {
+    'small': dict(width=4, length=4, height=4),
+    'default': {},
+    'large': dict(width=20, length=20, height=20),
+}
+
 
 def brick():
     return Manifold.cube(brick_length, brick_depth, brick_height)
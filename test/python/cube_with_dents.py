@@ -3,6 +3,12 @@ from functools import reduce
 
 # https://gist.github.com/ochafik/2db96400e3c1f73558fcede990b8a355#file-cube-with-half-spheres-dents-scad
 
+SCALES = {
+    'small': dict(n=3),
+    'default': {},
+    'large': dict(n=15),
+}
+
 def run(n=5, overlap=True):
     a = Manifold.cube(n, n, 0.5).translate(-0.5, -0.5, -0.5)
 
@@ -1,22 +1,155 @@
+"""Benchmark runner for the pymanifold models in this directory.
+
+Each model is a module with a run(**params) function returning a Manifold,
+and optionally a SCALES dict mapping scale names to those params. Every run
+builds the model and then evaluates it, with the time split into:
+
+  build     Python code building the lazy CSG tree, up to run() returning
+  evaluate  the Boolean evaluation forced by num_tri()
+  core      time spent inside the library, from pymanifold.core_seconds()
+  binding   total - core: Python and binding overhead
+
+Without arguments, each model runs once at its default scale, as a smoke test.
+"""
+import argparse
+import importlib
+import json
+import os
 import pathlib
+import platform
+import statistics
 import sys
-import importlib
-from time import time
+from time import perf_counter
+
+import pymanifold
+
+METRICS = ['total', 'build', 'evaluate', 'core', 'binding']
+
+
+def load_models(directory, filter_text):
+    models = {}
+    for path in sorted(directory.glob('*.py')):
+        name = path.stem
+        if path.resolve() == pathlib.Path(__file__).resolve():
+            continue
+        if filter_text and filter_text not in name:
+            continue
+        module = importlib.import_module(name)
+        if hasattr(module, 'run'):
+            models[name] = module
+    return models
+
+
+def time_once(module, params):
+    core0 = pymanifold.core_seconds()
+    t0 = perf_counter()
+    model = module.run(**params)
+    t1 = perf_counter()
+    num_tri = model.num_tri()
+    t2 = perf_counter()
+    core = pymanifold.core_seconds() - core0
+    sample = {'total': t2 - t0, 'build': t1 - t0, 'evaluate': t2 - t1,
+              'core': core, 'binding': t2 - t0 - core}
+    return model, num_tri, sample
+
+
+def benchmark(module, params, threads, warmup, repeats):
+    """Runs inside an ExecutionContext limited to threads (0 for default)."""
+    result = {}
+
+    def task():
+        for _ in range(warmup):
+            time_once(module, params)
+        samples = []
+        for _ in range(repeats):
+            model, num_tri, sample = time_once(module, params)
+            samples.append(sample)
+        result['model'] = model
+        result['numTri'] = num_tri
+        result['samples'] = samples
+
+    pymanifold.execute(task, max_threads=threads)
+    return result
+
+
+def summarize(samples):
+    summary = {}
+    for metric in METRICS:
+        values = [sample[metric] for sample in samples]
+        summary[metric] = {'min': min(values),
+                           'median': statistics.median(values),
+                           'mean': statistics.mean(values),
+                           'max': max(values)}
+    return summary
+
+
+def parse_threads(text):
+    if text == 'sweep':
+        cores = os.cpu_count() or 1
+        threads = []
+        n = 1
+        while n < cores:
+            threads.append(n)
+            n *= 2
+        return threads + [cores]
+    return [int(n) for n in text.split(',')]
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('-e', '--export', action='store_true',
+                        help='export each model to <name>_<scale>.glb')
+    parser.add_argument('--filter', default='',
+                        help='only run models whose name contains this')
+    parser.add_argument('--scales', default='default',
+                        help="comma-separated scale names, or 'all'")
+    parser.add_argument('--threads', default='0',
+                        help="comma-separated thread counts (0 for the "
+                        "default), or 'sweep' for 1, 2, 4... all cores")
+    parser.add_argument('--warmup', type=int, default=0,
+                        help='untimed runs before timing')
+    parser.add_argument('--repeats', type=int, default=1,
+                        help='timed runs per model, scale and thread count')
+    parser.add_argument('--out', help='write the results as JSON here')
+    args = parser.parse_args()
+
+    directory = pathlib.Path(__file__).parent
+    sys.path.insert(0, str(directory))
+    models = load_models(directory, args.filter)
+    threads = parse_threads(args.threads)
+
+    results = []
+    for name, module in models.items():
+        scales = getattr(module, 'SCALES', {'default': {}})
+        names = list(scales) if args.scales == 'all' else [
+            s for s in args.scales.split(',') if s in scales]
+        for scale in names:
+            for n in threads:
+                result = benchmark(module, scales[scale], n, args.warmup,
+                                   args.repeats)
+                summary = summarize(result['samples'])
+                results.append({'name': name, 'scale': scale, 'threads': n,
+                                'numTri': result['numTri'],
+                                'repeats': args.repeats, **summary})
+                print(f"{name} ({scale}, {n or 'default'} threads): "
+                      f"{summary['total']['median']*1000:.1f}ms, "
+                      f"{summary['binding']['median']*1000:.1f}ms outside "
+                      f"the library, {result['numTri']} triangles")
+                if args.export:
+                    filename = f'{name}_{scale}.glb'
+                    result['model'].export(filename)
+                    print(f'Exported model to {filename}')
+
+    if args.out:
+        with open(args.out, 'w') as out:
+            json.dump({'python': platform.python_version(),
+                       'platform': platform.platform(),
+                       'hardwareThreads': os.cpu_count(),
+                       'warmup': args.warmup,
+                       'benchmarks': results}, out, indent=2)
+
 
 if __name__ == "__main__":
-    current_file = pathlib.Path(__file__)
-    current_dir = current_file.parent
-    files = [f.parts[-1][:-3]
-             for f in current_dir.glob('*.py') if f != current_file]
-
-    export_models = len(sys.argv) == 2 and sys.argv[-1] == '-e'
-
-    for f in files:
-        module = importlib.import_module(f)
-        t0 = time()
-        model = module.run()
-        if export_models:
-            model.export(f'{f}.glb')
-            print(f'Exported model to {f}.glb')
-        t1 = time()
-        print(f'Took {(t1-t0)*1000:.1f}ms for {f}')
+    main()
@@ -36,4 +36,6 @@ int main(int argc, char **argv) {
   std::cout << "Genus = " << manifold.Genus() << std::endl;
   std::cout << manifold.NumDegenerateTris() << " degenerate triangles"
             << std::endl;
+  std::cout << manifold.NumSelfIntersections()
+            << " self-intersecting triangle pairs" << std::endl;
 }
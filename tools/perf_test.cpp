@@ -12,23 +12,347 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "manifold.h"
+#include "meshIO.h"
+#include "polygon.h"
+#include "samples.h"
 
 using namespace manifold;
 
-int main(int argc, char **argv) {
-  for (int i = 0; i < 8; ++i) {
-    Manifold sphere = Manifold::Sphere(1, (8 << i) * 4);
-    Manifold sphere2 = sphere.Translate(glm::vec3(0.5));
-    auto start = std::chrono::high_resolution_clock::now();
-    Manifold diff = sphere - sphere2;
-    diff.NumTri();
-    auto end = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<double> elapsed = end - start;
-    std::cout << "nTri = " << sphere.NumTri() << ", time = " << elapsed.count()
-              << " sec" << std::endl;
+namespace {
+
+#if MANIFOLD_PAR == 'O'
+constexpr char kBackend[] = "OMP";
+#elif MANIFOLD_PAR == 'T'
+constexpr char kBackend[] = "TBB";
+#else
+constexpr char kBackend[] = "CPP";
+#endif
+
+/**
+ * Setup builds the inputs, untimed, and returns the operation to time, which
+ * returns the size of its output, e.g. its number of triangles. Both run
+ * inside the ExecutionContext of the thread count being measured.
+ */
+struct Benchmark {
+  std::string name;
+  std::function<std::function<int()>()> setup;
+};
+
+struct Result {
+  std::string name;
+  int threads;
+  std::vector<double> seconds;
+  int size;
+};
+
+struct Options {
+  std::vector<int> threads;
+  int repeats = 5;
+  std::string filter;
+  std::string dataDir = "test/data";
+  std::string output;
+};
+
+Polygons Circle(float radius, int n, glm::vec2 center = glm::vec2(0.0f),
+                bool hole = false) {
+  SimplePolygon circle;
+  for (int i = 0; i < n; ++i) {
+    const float angle = (hole ? -2 : 2) * glm::pi<float>() * i / n;
+    circle.push_back(
+        {center + radius * glm::vec2(glm::cos(angle), glm::sin(angle)), i});
+  }
+  return {circle};
+}
+
+/**
+ * A disk with a grid of circular holes, which exercises the merging of many
+ * contours.
+ */
+Polygons Swiss(int holesPerSide) {
+  Polygons polys = Circle(holesPerSide, 64 * holesPerSide);
+  const float spacing = 2.0f * holesPerSide / (holesPerSide + 1);
+  for (int i = 0; i < holesPerSide; ++i) {
+    for (int j = 0; j < holesPerSide; ++j) {
+      const glm::vec2 center(spacing * (i + 1) - holesPerSide,
+                             spacing * (j + 1) - holesPerSide);
+      if (glm::length(center) + spacing > holesPerSide) continue;
+      const Polygons hole = Circle(spacing / 4, 16, center, true);
+      polys.push_back(hole[0]);
+    }
+  }
+  int idx = 0;
+  for (SimplePolygon& poly : polys) {
+    for (PolyVert& vert : poly) vert.idx = idx++;
+  }
+  return polys;
+}
+
+/**
+ * A comb with many teeth, whose monotone decomposition has many splits.
+ */
+Polygons Comb(int teeth) {
+  SimplePolygon comb;
+  int idx = 0;
+  comb.push_back({{0.0f, 0.0f}, idx++});
+  comb.push_back({{2.0f * teeth, 0.0f}, idx++});
+  for (int i = teeth; i > 0; --i) {
+    comb.push_back({{2.0f * i, 10.0f}, idx++});
+    comb.push_back({{2.0f * i - 1, 10.0f}, idx++});
+    comb.push_back({{2.0f * i - 1, 1.0f}, idx++});
+    comb.push_back({{2.0f * i - 2, 1.0f}, idx++});
+  }
+  return {comb};
+}
+
+Manifold Grid(const Manifold& part, int n, float spacing) {
+  std::vector<Manifold> parts;
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < n; ++j) {
+      for (int k = 0; k < n; ++k) {
+        parts.push_back(part.Translate(spacing * glm::vec3(i, j, k)));
+      }
+    }
+  }
+  return Manifold::Compose(parts);
+}
+
+std::vector<Benchmark> Benchmarks(const Options& options) {
+  std::vector<Benchmark> benchmarks;
+
+  for (int i = 0; i < 5; ++i) {
+    const int segments = (8 << i) * 4;
+    benchmarks.push_back(
+        {"Boolean/SphereDifference/" + std::to_string(segments), [segments]() {
+           Manifold sphere = Manifold::Sphere(1, segments);
+           Manifold sphere2 = sphere.Translate(glm::vec3(0.5));
+           return [=]() { return (sphere - sphere2).NumTri(); };
+         }});
+  }
+  benchmarks.push_back({"Boolean/SphereIntersection/256", []() {
+                          Manifold sphere = Manifold::Sphere(1, 256);
+                          Manifold sphere2 = sphere.Translate(glm::vec3(0.5));
+                          return [=]() { return (sphere ^ sphere2).NumTri(); };
+                        }});
+  benchmarks.push_back({"Boolean/UnionOfCubes/512", []() {
+                          Manifold cube = Manifold::Cube(glm::vec3(1.0f));
+                          std::vector<Manifold> cubes;
+                          for (int i = 0; i < 512; ++i) {
+                            cubes.push_back(cube.Translate(
+                                glm::vec3(i % 8, (i / 8) % 8, i / 64) * 0.7f));
+                          }
+                          return [=]() {
+                            Manifold result;
+                            for (const Manifold& part : cubes) result += part;
+                            return result.NumTri();
+                          };
+                        }});
+
+  benchmarks.push_back({"Compose/Spheres/1000", []() {
+                          Manifold sphere = Manifold::Sphere(0.4f, 32);
+                          sphere.NumTri();
+                          return [=]() { return Grid(sphere, 10, 1).NumTri(); };
+                        }});
+  benchmarks.push_back({"Decompose/Spheres/1000", []() {
+                          Manifold spheres =
+                              Grid(Manifold::Sphere(0.4f, 32), 10, 1);
+                          spheres.NumTri();
+                          return [=]() { return spheres.Decompose().size(); };
+                        }});
+
+  benchmarks.push_back({"Refine/Sphere/16", []() {
+                          Manifold sphere = Manifold::Sphere(1, 64);
+                          sphere.NumTri();
+                          return [=]() { return sphere.Refine(16).NumTri(); };
+                        }});
+  benchmarks.push_back({"Smooth/Tetrahedron/100", []() {
+                          Mesh tet = Manifold::Tetrahedron().GetMesh();
+                          return [=]() {
+                            return Manifold::Smooth(tet).Refine(100).NumTri();
+                          };
+                        }});
+
+  const std::vector<std::pair<std::string, Polygons>> polygons = {
+      {"Circle/100000", Circle(1, 100000)},
+      {"Swiss/20", Swiss(20)},
+      {"Comb/10000", Comb(10000)}};
+  for (const auto& polys : polygons) {
+    benchmarks.push_back({"Triangulate/" + polys.first, [polys]() {
+                            return [polys]() {
+                              return Triangulate(polys.second).size();
+                            };
+                          }});
+  }
+
+  std::vector<std::string> meshes;
+  if (std::filesystem::is_directory(options.dataDir)) {
+    for (const auto& entry :
+         std::filesystem::directory_iterator(options.dataDir)) {
+      if (entry.path().extension() == ".ply")
+        meshes.push_back(entry.path().string());
+    }
+  }
+  std::sort(meshes.begin(), meshes.end());
+  for (const std::string& file : meshes) {
+    benchmarks.push_back(
+        {"ImportMesh/" + std::filesystem::path(file).filename().string(),
+         [file]() {
+           return [file]() { return ImportMesh(file).triVerts.size(); };
+         }});
+  }
+
+  const std::vector<std::pair<std::string, std::function<Manifold()>>>
+      samples = {
+          {"TorusKnot", []() { return TorusKnot(1, 3, 25, 10, 3.75); }},
+          {"StretchyBracelet", []() { return StretchyBracelet(); }},
+          {"MengerSponge/3", []() { return MengerSponge(3); }},
+          {"RoundedFrame", []() { return RoundedFrame(100, 10); }},
+          {"TetPuzzle", []() { return TetPuzzle(50, 0.2, 50); }},
+          {"Scallop", []() { return Scallop(); }}};
+  for (const auto& sample : samples) {
+    benchmarks.push_back({"Samples/" + sample.first, [sample]() {
+                            return [sample]() {
+                              return sample.second().NumTri();
+                            };
+                          }});
+  }
+  return benchmarks;
+}
+
+std::vector<int> ParseList(const std::string& list) {
+  std::vector<int> values;
+  std::stringstream stream(list);
+  std::string value;
+  while (std::getline(stream, value, ',')) values.push_back(std::stoi(value));
+  return values;
+}
+
+/**
+ * Doubles from one thread up to the number of hardware threads, which is
+ * always included last.
+ */
+std::vector<int> DefaultThreads() {
+  const int cores = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<int> threads;
+  for (int n = 1; n < cores; n *= 2) threads.push_back(n);
+  threads.push_back(cores);
+  return threads;
+}
+
+Result Run(const Benchmark& benchmark, int threads, int repeats) {
+  Result result{benchmark.name, threads, {}, 0};
+  ExecutionContext context;
+  context.maxThreads = threads;
+  context.Execute([&]() {
+    const std::function<int()> run = benchmark.setup();
+    result.size = run();  // warm up
+    for (int i = 0; i < repeats; ++i) {
+      const auto start = std::chrono::high_resolution_clock::now();
+      run();
+      const auto end = std::chrono::high_resolution_clock::now();
+      result.seconds.push_back(
+          std::chrono::duration<double>(end - start).count());
+    }
+  });
+  return result;
+}
+
+void WriteJSON(std::ostream& out, const Options& options,
+               const std::vector<Result>& results) {
+  out << "{\n  \"backend\": \"" << kBackend << "\",\n"
+      << "  \"hardwareThreads\": " << std::thread::hardware_concurrency()
+      << ",\n  \"repeats\": " << options.repeats << ",\n"
+      << "  \"benchmarks\": [";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const Result& result = results[i];
+    std::vector<double> sorted = result.seconds;
+    std::sort(sorted.begin(), sorted.end());
+    double mean = 0;
+    for (double s : sorted) mean += s / sorted.size();
+    out << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << result.name
+        << "\", \"threads\": " << result.threads
+        << ", \"size\": " << result.size << ", \"min\": " << sorted.front()
+        << ", \"median\": " << sorted[sorted.size() / 2]
+        << ", \"mean\": " << mean << ", \"max\": " << sorted.back() << "}";
+  }
+  out << "\n  ]\n}" << std::endl;
+}
+
+void Usage(const char* program) {
+  std::cerr
+      << "Usage: " << program << " [options]\n"
+      << "  --filter <text>     only run benchmarks whose name contains it\n"
+      << "  --threads <n,n,..>  thread counts to sweep (default 1,2,4..all)\n"
+      << "  --repeats <n>       timed runs per benchmark (default 5)\n"
+      << "  --data <dir>        directory of .ply files (default test/data)\n"
+      << "  --out <file>        write the JSON here instead of stdout\n"
+      << "  --list              print the benchmark names and exit\n";
+}
+}  // namespace
+
+/**
+ * Times the main operations of the library, the samples and mesh import over
+ * a sweep of thread counts, and reports every timing as JSON so that results
+ * can be compared across commits and releases.
+ */
+int main(int argc, char** argv) {
+  Options options;
+  bool list = false;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool hasValue = i + 1 < argc;
+    if (arg == "--filter" && hasValue) {
+      options.filter = argv[++i];
+    } else if (arg == "--threads" && hasValue) {
+      options.threads = ParseList(argv[++i]);
+    } else if (arg == "--repeats" && hasValue) {
+      options.repeats = std::max(1, std::stoi(argv[++i]));
+    } else if (arg == "--data" && hasValue) {
+      options.dataDir = argv[++i];
+    } else if (arg == "--out" && hasValue) {
+      options.output = argv[++i];
+    } else if (arg == "--list") {
+      list = true;
+    } else {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+  if (options.threads.empty()) options.threads = DefaultThreads();
+
+  std::vector<Result> results;
+  for (const Benchmark& benchmark : Benchmarks(options)) {
+    if (benchmark.name.find(options.filter) == std::string::npos) continue;
+    if (list) {
+      std::cout << benchmark.name << std::endl;
+      continue;
+    }
+    for (int threads : options.threads) {
+      results.push_back(Run(benchmark, threads, options.repeats));
+      const std::vector<double>& seconds = results.back().seconds;
+      std::cerr << benchmark.name << " threads=" << threads << " min="
+                << *std::min_element(seconds.begin(), seconds.end()) << " s"
+                << std::endl;
+    }
+  }
+  if (list) return 0;
+
+  if (options.output.empty()) {
+    WriteJSON(std::cout, options, results);
+  } else {
+    std::ofstream out(options.output);
+    WriteJSON(out, options, results);
   }
+  return 0;
 }
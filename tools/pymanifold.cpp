@@ -1,3 +1,7 @@
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+
 #include "manifold.h"
 #include "meshIO.h"
 #include "pybind11/functional.h"
@@ -10,15 +14,105 @@ namespace py = pybind11;
 
 using namespace manifold;
 
-void exportManifold(Manifold &m, std::string name) {
-  Mesh out = m.GetMesh();
+// Exports without a copy of the mesh where the format allows.
+void exportManifold(const Manifold &m, const std::string &name) {
   manifold::ExportOptions options;
   options.faceted = true;
   options.mat.roughness = 0.2;
   options.mat.metalness = 0.0;
-  manifold::ExportMesh(name, out, options);
+  manifold::ExportMesh(name, m, options);
+};
+
+// Nanoseconds spent in calls into the library, summed over threads.
+std::atomic<int64_t> coreNanos(0);
+
+// Releases the GIL for a call into the library and counts its duration, so
+// that benchmarks can tell the library's time from the binding's.
+struct CoreScope {
+  py::gil_scoped_release release;
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+
+  ~CoreScope() {
+    coreNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+  }
 };
 
+// Whether each row's three elements are packed and rows are forward, so the
+// array can be read in place as a strided buffer.
+bool IsRowPacked(const py::array &array) {
+  return array.strides(1) == array.itemsize() &&
+         array.strides(0) >= 3 * array.itemsize();
+}
+
+// Builds a Manifold straight from the arrays' memory where their type and
+// layout allow, and otherwise from a packed copy made by numpy.
+Manifold FromArrays(py::array verts, py::array tris) {
+  if (verts.ndim() != 2 || verts.shape(1) != 3)
+    throw std::runtime_error("verts must have shape (N, 3)");
+  if (tris.ndim() != 2 || tris.shape(1) != 3)
+    throw std::runtime_error("tris must have shape (M, 3)");
+
+  const bool isDouble = py::isinstance<py::array_t<double>>(verts);
+  if (!(isDouble || py::isinstance<py::array_t<float>>(verts)) ||
+      !IsRowPacked(verts))
+    verts = py::array_t<float, py::array::c_style | py::array::forcecast>(
+        verts);
+  const bool isIndex = py::isinstance<py::array_t<int32_t>>(tris) ||
+                       py::isinstance<py::array_t<uint32_t>>(tris) ||
+                       py::isinstance<py::array_t<uint16_t>>(tris);
+  if (!isIndex) {
+    // Check wider indices before they are narrowed, which could wrap an
+    // out-of-range index onto a valid one.
+    py::array_t<int64_t, py::array::c_style | py::array::forcecast> wide(
+        tris);
+    const int64_t *index = wide.data();
+    const int64_t numVert = verts.shape(0);
+    for (py::ssize_t i = 0; i < wide.size(); ++i)
+      if (index[i] < 0 || index[i] >= numVert)
+        throw std::out_of_range("Vertex index out of range.");
+    tris = wide;
+  }
+  if (!isIndex || !IsRowPacked(tris))
+    tris = py::array_t<int32_t, py::array::c_style | py::array::forcecast>(
+        tris);
+
+  MeshView view;
+  view.vertPos = verts.data();
+  view.numVert = verts.shape(0);
+  view.vertStride = verts.strides(0);
+  view.doublePositions = verts.itemsize() == sizeof(double);
+  view.triVerts = tris.data();
+  view.numTri = tris.shape(0);
+  view.triStride = tris.strides(0);
+  view.indexBytes = tris.itemsize();
+  CoreScope core;
+  return Manifold(view);
+}
+
+// Writes the mesh straight into new arrays. The evaluation that sizes them
+// runs without the GIL too.
+py::tuple ToArrays(const Manifold &manifold) {
+  int numVert, numTri;
+  {
+    CoreScope core;
+    numVert = manifold.NumVert();
+    numTri = manifold.NumTri();
+  }
+  py::array_t<float> verts({numVert, 3});
+  py::array_t<int32_t> tris({numTri, 3});
+  MeshBuffers buffers;
+  buffers.vertPos = verts.mutable_data();
+  buffers.triVerts = tris.mutable_data();
+  {
+    CoreScope core;
+    manifold.GetMesh(buffers);
+  }
+  return py::make_tuple(verts, tris);
+}
+
 typedef std::tuple<float, float> Float2;
 typedef std::tuple<float, float, float> Float3;
 
@@ -32,13 +126,30 @@ PYBIND11_MODULE(pymanifold, m) {
       "documentation for APIs.\n"
       "This binding will perform copying to make the API more familiar to "
       "OpenSCAD users.";
+  m.def(
+      "execute",
+      [](const std::function<void()> &f, int maxThreads) {
+        ExecutionContext context;
+        context.maxThreads = maxThreads;
+        py::gil_scoped_release release;
+        context.Execute([&f]() { f(); });
+      },
+      py::arg("f"), py::arg("max_threads") = 0,
+      "Call f with the library limited to max_threads threads, or the "
+      "default for 0.");
+  m.def(
+      "core_seconds",
+      []() { return coreNanos.load() * 1e-9; },
+      "Total seconds spent in calls into the library, summed over threads. "
+      "Its change across some Python code is the part of that code's time "
+      "taken by the library rather than the binding.");
+
   py::class_<Manifold>(m, "Manifold")
       .def(py::init<>())
       .def(py::init([](std::vector<Manifold> &manifolds) {
-             Manifold result;
-             for (Manifold &manifold : manifolds) result += manifold;
-             return result;
+             return Manifold::BatchBoolean(manifolds, Manifold::OpType::ADD);
            }),
+           py::call_guard<CoreScope>(),
            "Construct manifold as the union of a set of manifolds.")
       .def(py::self + py::self)
       .def(py::self - py::self)
@@ -88,15 +199,24 @@ PYBIND11_MODULE(pymanifold, m) {
           py::arg("z_degrees") = 0.0f)
       .def(
           "export",
-          [](Manifold &self, std::string name) { exportManifold(self, name); },
-          py::arg("filename"),
+          [](const Manifold &self, const std::string &name) {
+            exportManifold(self, name);
+          },
+          py::arg("filename"), py::call_guard<CoreScope>(),
           "Export the manifold object to file, where the file type is "
           "determined from file extension.")
       .def(
           "warp",
           [](Manifold self, const std::function<Float3(Float3)> &f) {
+            CoreScope core;
             return self.Warp([&f](glm::vec3 &v) {
+              // Only the callback holds the GIL, and its time is not core.
+              py::gil_scoped_acquire acquire;
+              const auto start = std::chrono::steady_clock::now();
               Float3 fv = f(std::make_tuple(v.x, v.y, v.z));
+              coreNanos -= std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::steady_clock::now() - start)
+                               .count();
               v.x = std::get<0>(fv);
               v.y = std::get<1>(fv);
               v.z = std::get<2>(fv);
@@ -105,19 +225,80 @@ PYBIND11_MODULE(pymanifold, m) {
           py::arg("f"))
       .def(
           "refine", [](Manifold self, int n) { return self.Refine(n); },
-          py::arg("n"))
-      .def("to_mesh", &Manifold::GetMesh)
-      .def_static("smooth", Manifold::Smooth)
+          py::arg("n"), py::call_guard<CoreScope>())
+      .def("to_mesh",
+           static_cast<Mesh (Manifold::*)() const>(&Manifold::GetMesh),
+           py::call_guard<CoreScope>())
+      .def("num_vert", &Manifold::NumVert, py::call_guard<CoreScope>(),
+           "Number of vertices, which evaluates any pending operations.")
+      .def("num_tri", &Manifold::NumTri, py::call_guard<CoreScope>(),
+           "Number of triangles, which evaluates any pending operations.")
+      .def("to_arrays", &ToArrays,
+           "Return the mesh as a tuple of numpy arrays: vertex positions of "
+           "shape (N, 3) and dtype float32, and triangle vertex indices of "
+           "shape (M, 3) and dtype int32.")
+      .def(
+          "serialize",
+          [](const Manifold &self) {
+            std::string data;
+            {
+              CoreScope core;
+              data = self.Serialize();
+            }
+            return py::bytes(data);
+          },
+          "Serialize the CSG tree without evaluating it, with its leaf "
+          "meshes embedded, for deserialize() in another process.")
+      .def_static(
+          "deserialize",
+          [](const std::string &data) { return Manifold::Deserialize(data); },
+          py::arg("data"), py::call_guard<CoreScope>(),
+          "Rebuild a manifold from serialize() output, evaluated lazily as "
+          "usual.")
+      .def_static("smooth", Manifold::Smooth,
+                  py::call_guard<CoreScope>())
       .def_static(
           "from_mesh", [](const Mesh &mesh) { return Manifold(mesh); },
-          py::arg("mesh"))
-      .def_static("tetrahedron", []() { return Manifold::Tetrahedron(); })
+          py::arg("mesh"), py::call_guard<CoreScope>())
+      .def_static("from_arrays", &FromArrays, py::arg("verts"),
+                  py::arg("tris"),
+                  "Construct a manifold from numpy arrays of vertex positions "
+                  "of shape (N, 3) and triangle vertex indices of shape "
+                  "(M, 3). float32 or float64 positions and int32, uint32 or "
+                  "uint16 indices are read in place, including strided "
+                  "views; other types are converted first. Indices out of "
+                  "range raise IndexError or RuntimeError.")
+      .def_static(
+          "batch_union",
+          [](const std::vector<Manifold> &manifolds) {
+            return Manifold::BatchBoolean(manifolds, Manifold::OpType::ADD);
+          },
+          py::arg("manifolds"), py::call_guard<CoreScope>(),
+          "Union a list of manifolds as one batch, which is much faster than "
+          "adding them one at a time.")
+      .def_static(
+          "batch_difference",
+          [](const std::vector<Manifold> &manifolds) {
+            return Manifold::BatchBoolean(manifolds,
+                                          Manifold::OpType::SUBTRACT);
+          },
+          py::arg("manifolds"), py::call_guard<CoreScope>(),
+          "Subtract all the other manifolds of a list from the first, as one "
+          "batch.")
+      .def_static("compose", &Manifold::Compose, py::arg("manifolds"),
+                  py::call_guard<CoreScope>(),
+                  "Combine a list of manifolds that do not overlap into one, "
+                  "without any Boolean operation.")
+      .def_static(
+          "tetrahedron", []() { return Manifold::Tetrahedron(); },
+          py::call_guard<CoreScope>())
       .def_static(
           "cube",
           [](float x, float y, float z, bool center = false) {
             return Manifold::Cube(glm::vec3(x, y, z), center);
           },
-          py::arg("x"), py::arg("y"), py::arg("z"), py::arg("center") = false)
+          py::arg("x"), py::arg("y"), py::arg("z"), py::arg("center") = false,
+          py::call_guard<CoreScope>())
       .def_static(
           "cylinder",
           [](float height, float radiusLow, float radiusHigh = -1.0f,
@@ -126,13 +307,15 @@ PYBIND11_MODULE(pymanifold, m) {
                                       circularSegments);
           },
           py::arg("height"), py::arg("radius_low"),
-          py::arg("radius_high") = -1.0f, py::arg("circular_segments") = 0)
+          py::arg("radius_high") = -1.0f, py::arg("circular_segments") = 0,
+          py::call_guard<CoreScope>())
       .def_static(
           "sphere",
           [](float radius, int circularSegments = 0) {
             return Manifold::Sphere(radius, circularSegments);
           },
-          py::arg("radius"), py::arg("circular_segments") = 0);
+          py::arg("radius"), py::arg("circular_segments") = 0,
+          py::call_guard<CoreScope>());
 
   py::class_<PolygonsWrapper>(m, "Polygons")
       .def(py::init([](std::vector<std::vector<Float2>> &polygons) {
@@ -162,13 +345,15 @@ PYBIND11_MODULE(pymanifold, m) {
           },
           py::arg("height"), py::arg("n_divisions") = 0,
           py::arg("twist_degrees") = 0.0f,
-          py::arg("scale_top") = std::make_tuple(1.0f, 1.0f))
+          py::arg("scale_top") = std::make_tuple(1.0f, 1.0f),
+          py::call_guard<CoreScope>())
       .def(
           "revolve",
           [](PolygonsWrapper &self, int circularSegments = 0) {
             return Manifold::Revolve(*self.polygons, circularSegments);
           },
-          py::arg("circular_segments") = 0);
+          py::arg("circular_segments") = 0,
+          py::call_guard<CoreScope>());
 
   py::class_<Mesh>(m, "Mesh")
       .def(py::init([](py::array_t<float> &vertPos, py::array_t<int> &triVerts,
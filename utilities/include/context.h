@@ -0,0 +1,177 @@
+// Copyright 2022 Emmett Lalish
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "structs.h"
+
+namespace manifold {
+
+/** @addtogroup Core
+ *  @{
+ */
+
+/**
+ * Source of the memory behind the library's internal buffers. Each buffer
+ * keeps the Allocator it was created with, so it is returned to the same one
+ * even if it outlives the ExecutionContext.
+ */
+class Allocator {
+ public:
+  virtual ~Allocator() = default;
+  virtual void* Allocate(size_t bytes) = 0;
+  virtual void Deallocate(void* ptr, size_t bytes) = 0;
+};
+
+/**
+ * Classes of parallel primitives, which start to pay off in parallel at
+ * different sizes. autoPolicy() takes one as a hint.
+ */
+enum class OpKind { ForEach, Sort, Scan, Reduce };
+constexpr int kNumOpKind = 4;
+
+/**
+ * The workload sizes at which autoPolicy() switches policies.
+ */
+struct PolicyThresholds {
+  /// Workloads up to this size run sequentially, indexed by OpKind.
+  int seq[kNumOpKind] = {1 << 12, 1 << 12, 1 << 12, 1 << 12};
+  /// Workloads up to this size run on the CPU rather than the GPU.
+  int par = 1 << 16;
+};
+
+/**
+ * Progress and cooperative cancellation of a long evaluation, shared between
+ * the thread running it and those watching it. The work reports its steps at
+ * each Checkpoint(), which is also where a cancellation takes effect.
+ */
+class Progress {
+ public:
+  void Cancel() { canceled_ = true; }
+  bool IsCanceled() const { return canceled_; }
+  void AddSteps(int steps) { total_ += steps; }
+  void FinishSteps(int steps) { done_ += steps; }
+  void Finish() { finished_ = true; }
+  float Fraction() const;
+
+ private:
+  std::atomic<bool> canceled_{false};
+  std::atomic<bool> finished_{false};
+  std::atomic<int> total_{0};
+  std::atomic<int> done_{0};
+};
+
+/**
+ * Accounting of the bytes held by the library's internal buffers, in total and
+ * by the phase that allocated them, with an optional budget. Buffers report to
+ * the MemoryUsage of the ExecutionContext they were created in, even when they
+ * outlive it.
+ */
+class MemoryUsage {
+ public:
+  struct Site {
+    /// Bytes currently held by buffers allocated in this phase.
+    size_t current = 0;
+    /// The most bytes held at once by buffers allocated in this phase.
+    size_t peak = 0;
+    /// All bytes ever allocated in this phase.
+    size_t total = 0;
+  };
+
+  /// An allocation that would take the current bytes above a nonzero budget
+  /// throws memoryErr instead.
+  explicit MemoryUsage(size_t budget = 0) : budget_(budget) {}
+  size_t Current() const { return current_; }
+  size_t Peak() const { return peak_; }
+  size_t Budget() const { return budget_; }
+  void SetBudget(size_t budget) { budget_ = budget; }
+  void ResetPeak();
+  std::map<std::string, Site> BySite() const;
+
+  void Allocate(size_t bytes, const char* site);
+  void Deallocate(size_t bytes, const char* site);
+
+ private:
+  struct Counters {
+    std::atomic<size_t> current{0};
+    std::atomic<size_t> peak{0};
+    std::atomic<size_t> total{0};
+  };
+  // Maps the name pointers of the phases seen so far to the counters of their
+  // names without locking. Slots are only filled, under mutex_.
+  struct Slot {
+    std::atomic<const char*> site{nullptr};
+    std::atomic<Counters*> counters{nullptr};
+  };
+  static constexpr int kNumSlots = 64;
+
+  Counters& Find(const char* site);
+
+  std::atomic<size_t> current_{0};
+  std::atomic<size_t> peak_{0};
+  std::atomic<size_t> budget_;
+  Slot slots_[kNumSlots];
+  mutable std::mutex mutex_;
+  std::map<std::string, std::unique_ptr<Counters>> sites_;
+};
+
+PolicyThresholds CalibratePolicy(int maxSize = 1 << 20);
+PolicyThresholds LoadPolicy(const std::string& cacheFile,
+                            int maxSize = 1 << 20);
+PolicyThresholds DefaultPolicy();
+
+/**
+ * Settings for a group of operations, so that callers sharing a process, like
+ * the requests of a server, neither compete for every core nor see each
+ * other's settings. Operations inside Execute() use this context; all others
+ * use DefaultContext(), which the static setters of Manifold change when
+ * called outside of Execute().
+ */
+struct ExecutionContext {
+  /// Upper bound on the number of threads, 0 for the backend's default.
+  int maxThreads = 0;
+  /// Where buffers are allocated, or nullptr for the built-in allocation.
+  std::shared_ptr<Allocator> allocator;
+  /// See Manifold::SetCircularSegments().
+  int circularSegments = 0;
+  /// See Manifold::SetMinCircularAngle().
+  float circularAngle = 10.0f;
+  /// See Manifold::SetMinCircularEdgeLength().
+  float circularEdgeLength = 1.0f;
+  /// Checks and logging of the triangulator.
+  ExecutionParams polygonParams;
+  /// Where autoPolicy() switches policies.
+  PolicyThresholds thresholds = DefaultPolicy();
+  /// If set, receives the progress of evaluations and can cancel them.
+  std::shared_ptr<Progress> progress;
+  /// If set, called with the statistics of every Boolean operation.
+  std::function<void(const BooleanStats&)> onBoolean;
+  /// If set, counts the bytes of the buffers allocated in this context and
+  /// enforces its budget.
+  std::shared_ptr<MemoryUsage> memory;
+
+  void Execute(const std::function<void()>& task) const;
+};
+
+ExecutionContext& DefaultContext();
+ExecutionContext& CurrentContext();
+void Checkpoint(int steps = 1);
+/** @} */
+}  // namespace manifold
@@ -25,6 +25,8 @@
 #include <thrust/system/cuda/execution_policy.h>
 #endif
 
+#include "context.h"
+
 namespace manifold {
 
 void check_cuda_available();
@@ -48,12 +50,15 @@ constexpr ExecutionPolicy Seq = ExecutionPolicy::Seq;
 // - Sequential for small workload,
 // - Parallel (CPU) for medium workload,
 // - GPU for large workload if available.
-inline ExecutionPolicy autoPolicy(int size) {
-  // some random numbers
-  if (size <= (1 << 12)) {
+// The thresholds come from the current ExecutionContext, per kind of
+// primitive.
+inline ExecutionPolicy autoPolicy(int size, OpKind kind = OpKind::ForEach) {
+  const ExecutionContext& context = CurrentContext();
+  if (size <= context.thresholds.seq[static_cast<int>(kind)] ||
+      context.maxThreads == 1) {
     return Seq;
   }
-  if (size <= (1 << 16) || CUDA_ENABLED != 1) {
+  if (size <= context.thresholds.par || CUDA_ENABLED != 1) {
     return Par;
   }
   return ParUnseq;
@@ -126,6 +131,7 @@ THRUST_DYNAMIC_BACKEND_VOID(stable_sort)
 THRUST_DYNAMIC_BACKEND_VOID(fill)
 THRUST_DYNAMIC_BACKEND_VOID(sequence)
 THRUST_DYNAMIC_BACKEND_VOID(sort_by_key)
+THRUST_DYNAMIC_BACKEND_VOID(stable_sort_by_key)
 THRUST_DYNAMIC_BACKEND_VOID(copy)
 THRUST_DYNAMIC_BACKEND_VOID(transform)
 THRUST_DYNAMIC_BACKEND_VOID(inclusive_scan)
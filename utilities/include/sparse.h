@@ -61,7 +61,7 @@ class SparseIndices {
   int size() const { return p.size(); }
   void SwapPQ() { p.swap(q); }
 
-  void Sort() { sort(autoPolicy(size()), beginPQ(), endPQ()); }
+  void Sort() { sort(autoPolicy(size(), OpKind::Sort), beginPQ(), endPQ()); }
 
   void Resize(int size) {
     p.resize(size, -1);
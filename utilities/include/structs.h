@@ -43,6 +43,12 @@ struct topologyErr : public virtual std::runtime_error {
 struct geometryErr : public virtual std::runtime_error {
   using std::runtime_error::runtime_error;
 };
+struct canceledErr : public virtual std::runtime_error {
+  using std::runtime_error::runtime_error;
+};
+struct memoryErr : public virtual std::runtime_error {
+  using std::runtime_error::runtime_error;
+};
 using logicErr = std::logic_error;
 /** @} */
 
@@ -195,6 +201,75 @@ struct Mesh {
   std::vector<glm::vec4> halfedgeTangent;
 };
 
+/**
+ * A triangle mesh in buffers owned by the caller, such as those of another
+ * mesh library or numpy arrays, which Manifold can read without copying them
+ * into a Mesh first. Each buffer is read as elements a fixed number of bytes
+ * apart, so interleaved vertex data can be passed as is.
+ */
+struct MeshView {
+  /// Required: The X-Y-Z position of the first vertex, as three floats, or
+  /// three doubles if doublePositions.
+  const void* vertPos = nullptr;
+  /// The number of vertices.
+  int numVert = 0;
+  /// Bytes from the start of one position to the next, or 0 if packed.
+  int vertStride = 0;
+  /// Whether the positions are doubles rather than floats.
+  bool doublePositions = false;
+  /// Required: The three vertex indices of the first triangle in CCW (from the
+  /// outside) order, as unsigned integers of indexBytes each.
+  const void* triVerts = nullptr;
+  /// The number of triangles.
+  int numTri = 0;
+  /// Bytes from the start of one triangle's indices to the next, or 0 if
+  /// packed.
+  int triStride = 0;
+  /// The size of each index: 2 or 4 bytes.
+  int indexBytes = 4;
+};
+
+/**
+ * Buffers owned by the caller, such as a GPU staging buffer, into which
+ * Manifold.GetMesh() can write a mesh without allocating. Each must have room
+ * for Manifold.NumVert() vertices or Manifold.NumTri() triangles, and is
+ * written as elements a fixed number of bytes apart, so that several
+ * attributes can be interleaved in one buffer. Null buffers are skipped.
+ */
+struct MeshBuffers {
+  /// The X-Y-Z position of each vertex, as three floats.
+  void* vertPos = nullptr;
+  /// Bytes from the start of one position to the next, or 0 if packed.
+  int vertStride = 0;
+  /// The X-Y-Z normal of each vertex, as three floats.
+  void* vertNormal = nullptr;
+  /// Bytes from the start of one normal to the next, or 0 if packed.
+  int normalStride = 0;
+  /// The X-Y-Z-W tangent of each halfedge, as four floats, three per triangle
+  /// as in Mesh.halfedgeTangent. Left untouched if the Manifold has none.
+  void* halfedgeTangent = nullptr;
+  /// Bytes from the start of one tangent to the next, or 0 if packed.
+  int tangentStride = 0;
+  /// The three vertex indices of each triangle, as unsigned integers of
+  /// indexBytes each.
+  void* triVerts = nullptr;
+  /// Bytes from the start of one triangle's indices to the next, or 0 if
+  /// packed.
+  int triStride = 0;
+  /// The size of each index: 2 or 4 bytes. 2 requires at most 65536 vertices.
+  int indexBytes = 4;
+  /// The first vertex to write, so that a large mesh can be extracted in
+  /// chunks. The buffers start at this vertex.
+  int firstVert = 0;
+  /// The number of vertices to write, or -1 for all from firstVert.
+  int numVert = -1;
+  /// The first triangle to write, and its tangents. The buffers start at this
+  /// triangle, while its indices still refer to the whole mesh.
+  int firstTri = 0;
+  /// The number of triangles to write, or -1 for all from firstTri.
+  int numTri = -1;
+};
+
 /**
  * Defines which edges to sharpen and how much for the Manifold.Smooth()
  * constructor.
@@ -225,6 +300,48 @@ struct Curvature {
   std::vector<float> vertMeanCurvature, vertGaussianCurvature;
 };
 
+/**
+ * A pair of interfering manifolds, see Manifold.Interferences().
+ */
+struct Interference {
+  /// Indices into the input vector, with first < second.
+  int first, second;
+  /// The volume of their intersection if requested, otherwise NaN.
+  float volume;
+};
+
+/**
+ * Statistics of a single Boolean operation, see Manifold.GetBooleanStats().
+ * Times are in milliseconds.
+ */
+struct BooleanStats {
+  /// The sizes of the two operands.
+  int numTriP = 0, numTriQ = 0;
+  /// Finding the overlapping edges, faces and vertices.
+  float broadPhase = 0;
+  /// Computing the intersections and winding numbers.
+  float intersections = 0;
+  /// Building the faces of the result.
+  float assembly = 0;
+  /// Triangulating the faces of the result.
+  float triangulation = 0;
+  /// Removing the degenerate parts of the result.
+  float simplification = 0;
+  /// Sorting the result for its collider.
+  float sorting = 0;
+  /// Sizes of the sparse overlap arrays found by the broad phase.
+  int p1q2 = 0, p2q1 = 0, p0q2 = 0, p2q0 = 0, p1q1 = 0;
+  /// The numbers of edges of P crossing faces of Q and vice versa.
+  int x12 = 0, x21 = 0;
+  /// An estimate of the temporary memory, summed from the sizes of the sparse
+  /// and intersection arrays at the end of the intersection phase. It leaves
+  /// out the temporaries of assembling the result; set
+  /// ExecutionContext::memory to measure the actual usage and peak.
+  size_t tempBytesEstimate = 0;
+  /// The size of the result.
+  int numVert = 0, numTri = 0;
+};
+
 /**
  * Part of MeshRelation - represents a single triangle relation to an original
  * Mesh.
@@ -0,0 +1,78 @@
+// Copyright 2022 Emmett Lalish
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <string>
+
+namespace manifold {
+
+/** @addtogroup Core
+ *  @{
+ */
+void StartTrace(const std::string& filename);
+void StopTrace();
+/** @} */
+
+/** @addtogroup Private
+ *  @{
+ */
+using TraceClock = std::chrono::steady_clock;
+
+extern std::atomic<bool> traceEnabled;
+
+inline bool TraceEnabled() {
+  return traceEnabled.load(std::memory_order_relaxed);
+}
+
+void RecordTrace(const char* name, TraceClock::time_point start,
+                 TraceClock::time_point end);
+
+/**
+ * The name of the innermost TraceScope on this thread, or nullptr. Memory
+ * accounting charges allocations to it.
+ */
+inline const char*& CurrentPhase() {
+  thread_local const char* phase = nullptr;
+  return phase;
+}
+
+/**
+ * Marks a phase of an operation, whose name must be a string literal, for the
+ * lifetime of this object. The phase is recorded as a trace event while
+ * tracing is started, and otherwise costs about a relaxed load.
+ */
+class TraceScope {
+ public:
+  explicit TraceScope(const char* name)
+      : name_(name), previous_(CurrentPhase()), tracing_(TraceEnabled()) {
+    CurrentPhase() = name_;
+    if (tracing_) start_ = TraceClock::now();
+  }
+  ~TraceScope() {
+    CurrentPhase() = previous_;
+    if (tracing_) RecordTrace(name_, start_, TraceClock::now());
+  }
+  TraceScope(const TraceScope&) = delete;
+  TraceScope& operator=(const TraceScope&) = delete;
+
+ private:
+  const char* const name_;
+  const char* const previous_;
+  const bool tracing_;
+  TraceClock::time_point start_;
+};
+/** @} */
+}  // namespace manifold
@@ -24,6 +24,7 @@
 #include <iostream>
 
 #include "par.h"
+#include "trace.h"
 
 namespace manifold {
 
@@ -32,6 +33,11 @@ namespace manifold {
  *  @{
  */
 inline void MemUsage() {
+  const MemoryUsage* memory = CurrentContext().memory.get();
+  if (memory != nullptr) {
+    std::cout << "Buffers hold " << memory->Current() / 1048576 << " Mb (peak "
+              << memory->Peak() / 1048576 << " Mb)" << std::endl;
+  }
 #if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
   size_t free, total;
   cudaMemGetInfo(&free, &total);
@@ -51,11 +57,16 @@ inline void CheckDevice() {
 #endif
 }
 
+/**
+ * Measures the time between Start() and Stop(). If it is given a name, which
+ * must be a string literal, this interval is also recorded as a trace event
+ * while tracing is started; see StartTrace().
+ */
 struct Timer {
 #if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
   cudaEvent_t start, end;
 
-  Timer() {
+  explicit Timer(const char* name = nullptr) : name_(name) {
     cudaEventCreate(&start);
     cudaEventCreate(&end);
   }
@@ -65,9 +76,15 @@ struct Timer {
     cudaEventDestroy(end);
   }
 
-  void Start() { cudaEventRecord(start, 0); }
+  void Start() {
+    cudaEventRecord(start, 0);
+    BeginEvent();
+  }
 
-  void Stop() { cudaEventRecord(end, 0); }
+  void Stop() {
+    cudaEventRecord(end, 0);
+    EndEvent();
+  }
 
   float Elapsed() {
     cudaEventSynchronize(end);
@@ -78,18 +95,36 @@ struct Timer {
 #else
   std::chrono::high_resolution_clock::time_point start, end;
 
-  void Start() { start = std::chrono::high_resolution_clock::now(); }
+  explicit Timer(const char* name = nullptr) : name_(name) {}
 
-  void Stop() { end = std::chrono::high_resolution_clock::now(); }
+  void Start() {
+    start = std::chrono::high_resolution_clock::now();
+    BeginEvent();
+  }
+
+  void Stop() {
+    end = std::chrono::high_resolution_clock::now();
+    EndEvent();
+  }
 
   float Elapsed() {
-    return std::chrono::duration_cast<std::chrono::milliseconds>(end - start)
-        .count();
+    return std::chrono::duration<float, std::milli>(end - start).count();
   }
 #endif
-  void Print(std::string message) {
-    std::cout << "----------- " << std::round(Elapsed()) << " ms for "
-              << message << std::endl;
+
+ private:
+  const char* const name_;
+  bool tracing_ = false;
+  TraceClock::time_point traceStart_;
+
+  void BeginEvent() {
+    tracing_ = name_ != nullptr && TraceEnabled();
+    if (tracing_) traceStart_ = TraceClock::now();
+  }
+
+  void EndEvent() {
+    if (tracing_) RecordTrace(name_, traceStart_, TraceClock::now());
+    tracing_ = false;
   }
 };
 
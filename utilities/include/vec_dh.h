@@ -17,10 +17,16 @@
 #ifdef MANIFOLD_USE_CUDA
 #include <cuda.h>
 #endif
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <memory>
 
 #include "par.h"
 #include "structs.h"
+#include "trace.h"
 
 namespace manifold {
 
@@ -33,6 +39,9 @@ namespace manifold {
 // if the parameter val is not set. Also, this implementation is a toy
 // implementation that did not consider things like non-trivial
 // constructor/destructor, please keep T trivial.
+template <typename T>
+class VecDH;
+
 template <typename T>
 class ManagedVec {
  public:
@@ -51,7 +60,7 @@ class ManagedVec {
     capacity_ = n;
     onHost = autoPolicy(n) != ExecutionPolicy::ParUnseq;
     if (n == 0) return;
-    mallocManaged(&ptr_, size_ * sizeof(T));
+    site_ = mallocManaged(&ptr_, size_ * sizeof(T));
   }
 
   ManagedVec(size_t n, const T &val) {
@@ -60,13 +69,13 @@ class ManagedVec {
     if (n == 0) return;
     auto policy = autoPolicy(n);
     onHost = policy != ExecutionPolicy::ParUnseq;
-    mallocManaged(&ptr_, size_ * sizeof(T));
+    site_ = mallocManaged(&ptr_, size_ * sizeof(T));
     prefetch(ptr_, size_ * sizeof(T), onHost);
     uninitialized_fill_n(policy, ptr_, n, val);
   }
 
   ~ManagedVec() {
-    if (ptr_ != nullptr) freeManaged(ptr_);
+    if (ptr_ != nullptr) freeManaged(ptr_, capacity_, site_);
     ptr_ = nullptr;
     size_ = 0;
     capacity_ = 0;
@@ -78,7 +87,7 @@ class ManagedVec {
     auto policy = autoPolicy(size_);
     onHost = policy != ExecutionPolicy::ParUnseq;
     if (size_ != 0) {
-      mallocManaged(&ptr_, size_ * sizeof(T));
+      site_ = mallocManaged(&ptr_, size_ * sizeof(T));
       fastUninitializedCopy(ptr_, vec.data(), size_, policy);
     }
   }
@@ -89,13 +98,16 @@ class ManagedVec {
     auto policy = autoPolicy(size_);
     onHost = policy != ExecutionPolicy::ParUnseq;
     if (size_ != 0) {
-      mallocManaged(&ptr_, size_ * sizeof(T));
+      site_ = mallocManaged(&ptr_, size_ * sizeof(T));
       prefetch(ptr_, size_ * sizeof(T), onHost);
       uninitialized_copy(policy, vec.begin(), vec.end(), ptr_);
     }
   }
 
   ManagedVec(ManagedVec<T> &&vec) {
+    allocator_ = std::move(vec.allocator_);
+    memory_ = std::move(vec.memory_);
+    site_ = vec.site_;
     ptr_ = vec.ptr_;
     size_ = vec.size_;
     capacity_ = vec.capacity_;
@@ -107,13 +119,17 @@ class ManagedVec {
 
   ManagedVec &operator=(const ManagedVec<T> &vec) {
     if (&vec == this) return *this;
-    if (ptr_ != nullptr) freeManaged(ptr_);
-    size_ = vec.size_;
-    capacity_ = vec.size_;
-    auto policy = autoPolicy(size_);
+    if (ptr_ != nullptr) freeManaged(ptr_, capacity_, site_);
+    ptr_ = nullptr;
+    size_ = 0;
+    capacity_ = 0;
+    auto policy = autoPolicy(vec.size_);
     onHost = policy != ExecutionPolicy::ParUnseq;
-    if (size_ != 0) {
-      mallocManaged(&ptr_, size_ * sizeof(T));
+    if (vec.size_ != 0) {
+      // may throw memoryErr, which leaves this empty
+      site_ = mallocManaged(&ptr_, vec.size_ * sizeof(T));
+      size_ = vec.size_;
+      capacity_ = vec.size_;
       prefetch(ptr_, size_ * sizeof(T), onHost);
       uninitialized_copy(policy, vec.begin(), vec.end(), ptr_);
     }
@@ -122,7 +138,10 @@ class ManagedVec {
 
   ManagedVec &operator=(ManagedVec<T> &&vec) {
     if (&vec == this) return *this;
-    if (ptr_ != nullptr) freeManaged(ptr_);
+    if (ptr_ != nullptr) freeManaged(ptr_, capacity_, site_);
+    allocator_ = std::move(vec.allocator_);
+    memory_ = std::move(vec.memory_);
+    site_ = vec.site_;
     onHost = vec.onHost;
     size_ = vec.size_;
     capacity_ = vec.capacity_;
@@ -149,26 +168,29 @@ class ManagedVec {
   void reserve(size_t n) {
     if (n > capacity_) {
       T *newBuffer;
-      mallocManaged(&newBuffer, n * sizeof(T));
+      const char *newSite = mallocManaged(&newBuffer, n * sizeof(T));
       prefetch(newBuffer, size_ * sizeof(T), onHost);
       if (size_ > 0) {
         uninitialized_copy(autoPolicy(size_), ptr_, ptr_ + size_, newBuffer);
       }
-      if (ptr_ != nullptr) freeManaged(ptr_);
+      if (ptr_ != nullptr) freeManaged(ptr_, capacity_, site_);
       ptr_ = newBuffer;
+      site_ = newSite;
       capacity_ = n;
     }
   }
 
   void shrink_to_fit() {
     T *newBuffer = nullptr;
+    const char *newSite = nullptr;
     if (size_ > 0) {
-      mallocManaged(&newBuffer, size_ * sizeof(T));
+      newSite = mallocManaged(&newBuffer, size_ * sizeof(T));
       prefetch(newBuffer, size_ * sizeof(T), onHost);
       uninitialized_copy(autoPolicy(size_), ptr_, ptr_ + size_, newBuffer);
     }
-    freeManaged(ptr_);
+    if (ptr_ != nullptr) freeManaged(ptr_, capacity_, site_);
     ptr_ = newBuffer;
+    site_ = newSite;
     capacity_ = size_;
   }
 
@@ -189,6 +211,9 @@ class ManagedVec {
     std::swap(size_, other.size_);
     std::swap(capacity_, other.capacity_);
     std::swap(onHost, other.onHost);
+    std::swap(allocator_, other.allocator_);
+    std::swap(memory_, other.memory_);
+    std::swap(site_, other.site_);
   }
 
   void prefetch_to(bool toHost) const {
@@ -231,24 +256,71 @@ class ManagedVec {
   bool empty() const { return size_ == 0; }
 
  private:
+  // VecDH keeps the copy-on-write checks below, which it skips under NDEBUG.
+  friend class VecDH<T>;
+
+  // A hash of the contents, to check that a buffer shared by VecDH copies is
+  // not written through a pointer taken before it was shared.
+  uint64_t Checksum() const {
+    const char *bytes = reinterpret_cast<const char *>(ptr_);
+    const size_t n = size_ * sizeof(T);
+    uint64_t hash = n;
+    for (size_t i = 0; i < n; i += 8) {
+      uint64_t word = 0;
+      std::memcpy(&word, bytes + i, std::min<size_t>(8, n - i));
+      hash = (hash ^ word) * 0x9e3779b97f4a7c15ull;
+      hash ^= hash >> 29;
+    }
+    return hash;
+  }
+
+  // set when mutable access was given, so a pointer may still be held
+  std::atomic<bool> lent_{false};
+  // set while checksum_ holds the contents at the time the buffer was shared
+  std::atomic<bool> sealed_{false};
+  std::atomic<uint64_t> checksum_{0};
+
   T *ptr_ = nullptr;
   size_t size_ = 0;
   size_t capacity_ = 0;
   mutable bool onHost = true;
+  // taken from the ExecutionContext this buffer was created in
+  std::shared_ptr<Allocator> allocator_ = CurrentContext().allocator;
+  std::shared_ptr<MemoryUsage> memory_ = CurrentContext().memory;
+  // the phase ptr_ was allocated in, see CurrentPhase()
+  const char *site_ = nullptr;
 
   static constexpr int DEVICE_MAX_BYTES = 1 << 16;
 
-  static void mallocManaged(T **ptr, size_t bytes) {
+  // returns the phase charged for the allocation
+  const char *mallocManaged(T **ptr, size_t bytes) {
+    const char *site = CurrentPhase();
+    if (memory_ != nullptr) memory_->Allocate(bytes, site);
+    if (allocator_ != nullptr) {
+      *ptr = reinterpret_cast<T *>(allocator_->Allocate(bytes));
+    } else {
 #ifdef MANIFOLD_USE_CUDA
-    if (CUDA_ENABLED == -1) check_cuda_available();
-    if (CUDA_ENABLED)
-      cudaMallocManaged(reinterpret_cast<void **>(ptr), bytes);
-    else
+      if (CUDA_ENABLED == -1) check_cuda_available();
+      if (CUDA_ENABLED)
+        cudaMallocManaged(reinterpret_cast<void **>(ptr), bytes);
+      else
 #endif
-      *ptr = reinterpret_cast<T *>(malloc(bytes));
+        *ptr = reinterpret_cast<T *>(malloc(bytes));
+    }
+    if (*ptr == nullptr) {
+      if (memory_ != nullptr) memory_->Deallocate(bytes, site);
+      throw memoryErr("Failed to allocate " + std::to_string(bytes) +
+                      " bytes.");
+    }
+    return site;
   }
 
-  static void freeManaged(T *ptr) {
+  void freeManaged(T *ptr, size_t capacity, const char *site) {
+    if (memory_ != nullptr) memory_->Deallocate(capacity * sizeof(T), site);
+    if (allocator_ != nullptr) {
+      allocator_->Deallocate(ptr, capacity * sizeof(T));
+      return;
+    }
 #ifdef MANIFOLD_USE_CUDA
     if (CUDA_ENABLED)
       cudaFree(ptr);
@@ -300,6 +372,15 @@ class ManagedVec {
  * Note that it is *NOT SAFE* to first obtain a host(device) pointer, perform
  * some device(host) modification, and then read the host(device) pointer again
  * (on the same vector). The memory will be inconsistent in that case.
+ *
+ * Copies share their buffer until one of them is accessed through a non-const
+ * method, which first gives it a copy of its own, so that copying a whole
+ * Manifold::Impl is cheap and only the buffers that change are duplicated. For
+ * the same reason, a mutable pointer or iterator must not be kept across a
+ * copy of its vector. Read-only code should use the const accessors (cbegin(),
+ * cptrD(), ...), which never copy. Unless NDEBUG is defined, a write through
+ * such a stale pointer into a shared buffer is detected by the next mutable
+ * access of any of its copies, which throws logicErr.
  */
 template <typename T>
 class VecDH {
@@ -309,17 +390,23 @@ class VecDH {
   // Note that the vector constructed with this constructor will contain
   // uninitialized memory. Please specify `val` if you need to make sure that
   // the data is initialized.
-  VecDH(int size) { impl_.resize(size); }
+  VecDH(int size) { Mutable().resize(size); }
 
-  VecDH(int size, T val) { impl_.resize(size, val); }
+  VecDH(int size, T val) { Mutable().resize(size, val); }
 
-  VecDH(const std::vector<T> &vec) { impl_ = vec; }
+  VecDH(const std::vector<T> &vec) {
+    impl_ = std::make_shared<ManagedVec<T>>(vec);
+  }
 
-  VecDH(const VecDH<T> &other) { impl_ = other.impl_; }
+  VecDH(const VecDH<T> &other) {
+    other.Seal();
+    impl_ = other.impl_;
+  }
 
   VecDH(VecDH<T> &&other) { impl_ = std::move(other.impl_); }
 
   VecDH<T> &operator=(const VecDH<T> &other) {
+    other.Seal();
     impl_ = other.impl_;
     return *this;
   }
@@ -329,12 +416,12 @@ class VecDH {
     return *this;
   }
 
-  int size() const { return impl_.size(); }
+  int size() const { return impl_ == nullptr ? 0 : impl_->size(); }
 
   void resize(int newSize, T val = T()) {
     bool shrink = size() > 2 * newSize;
-    impl_.resize(newSize, val);
-    if (shrink) impl_.shrink_to_fit();
+    Mutable().resize(newSize, val);
+    if (shrink) impl_->shrink_to_fit();
   }
 
   void swap(VecDH<T> &other) { impl_.swap(other.impl_); }
@@ -343,78 +430,120 @@ class VecDH {
   using IterC = typename ManagedVec<T>::IterC;
 
   Iter begin() {
-    impl_.prefetch_to(autoPolicy(size()) != ExecutionPolicy::ParUnseq);
-    return impl_.begin();
+    Mutable().prefetch_to(autoPolicy(size()) != ExecutionPolicy::ParUnseq);
+    return impl_->begin();
   }
 
-  Iter end() { return impl_.end(); }
+  Iter end() { return Mutable().end(); }
 
   IterC cbegin() const {
-    impl_.prefetch_to(autoPolicy(size()) != ExecutionPolicy::ParUnseq);
-    return impl_.cbegin();
+    if (impl_ == nullptr) return nullptr;
+    impl_->prefetch_to(autoPolicy(size()) != ExecutionPolicy::ParUnseq);
+    return impl_->cbegin();
   }
 
-  IterC cend() const { return impl_.cend(); }
+  IterC cend() const { return impl_ == nullptr ? nullptr : impl_->cend(); }
 
   IterC begin() const { return cbegin(); }
   IterC end() const { return cend(); }
 
   T *ptrD() {
     if (size() == 0) return nullptr;
-    impl_.prefetch_to(autoPolicy(size()) != ExecutionPolicy::ParUnseq);
-    return impl_.data();
+    Mutable().prefetch_to(autoPolicy(size()) != ExecutionPolicy::ParUnseq);
+    return impl_->data();
   }
 
   const T *cptrD() const {
     if (size() == 0) return nullptr;
-    impl_.prefetch_to(autoPolicy(size()) != ExecutionPolicy::ParUnseq);
-    return impl_.data();
+    impl_->prefetch_to(autoPolicy(size()) != ExecutionPolicy::ParUnseq);
+    return impl_->data();
   }
 
   const T *ptrD() const { return cptrD(); }
 
   T *ptrH() {
     if (size() == 0) return nullptr;
-    impl_.prefetch_to(true);
-    return impl_.data();
+    Mutable().prefetch_to(true);
+    return impl_->data();
   }
 
   const T *cptrH() const {
     if (size() == 0) return nullptr;
-    impl_.prefetch_to(true);
-    return impl_.data();
+    impl_->prefetch_to(true);
+    return impl_->data();
   }
 
   const T *ptrH() const { return cptrH(); }
 
   T &operator[](int i) {
-    impl_.prefetch_to(true);
-    return impl_[i];
+    Mutable().prefetch_to(true);
+    return (*impl_)[i];
   }
 
   const T &operator[](int i) const {
-    impl_.prefetch_to(true);
-    return impl_[i];
+    impl_->prefetch_to(true);
+    return (*impl_)[i];
   }
 
-  T &back() { return impl_.back(); }
+  T &back() { return Mutable().back(); }
+
+  const T &back() const { return impl_->back(); }
 
-  const T &back() const { return impl_.back(); }
+  void push_back(const T &val) { Mutable().push_back(val); }
 
-  void push_back(const T &val) { impl_.push_back(val); }
+  void reserve(int n) { Mutable().reserve(n); }
 
-  void reserve(int n) { impl_.reserve(n); }
+  /**
+   * Whether the buffer is shared with a copy of this vector, for testing.
+   */
+  bool IsShared() const { return impl_ != nullptr && impl_.use_count() > 1; }
 
   void Dump() const {
     std::cout << "VecDH = " << std::endl;
-    for (int i = 0; i < impl_.size(); ++i) {
-      std::cout << i << ", " << impl_[i] << ", " << std::endl;
+    for (int i = 0; i < size(); ++i) {
+      std::cout << i << ", " << (*impl_)[i] << ", " << std::endl;
     }
     std::cout << std::endl;
   }
 
  private:
-  ManagedVec<T> impl_;
+  // shared between copies until one of them asks for mutable access
+  std::shared_ptr<ManagedVec<T>> impl_;
+
+  ManagedVec<T> &Mutable() {
+    if (impl_ == nullptr) {
+      impl_ = std::make_shared<ManagedVec<T>>();
+    } else {
+      CheckSealed();
+      if (impl_.use_count() > 1) {
+        impl_ = std::make_shared<ManagedVec<T>>(*impl_);
+      }
+    }
+#ifndef NDEBUG
+    impl_->lent_ = true;
+#endif
+    return *impl_;
+  }
+
+  // Records the contents of a buffer that is about to be shared, if a mutable
+  // pointer to it may still be held.
+  void Seal() const {
+#ifndef NDEBUG
+    if (impl_ == nullptr || !impl_->lent_.exchange(false)) return;
+    impl_->checksum_ = impl_->Checksum();
+    impl_->sealed_ = true;
+#endif
+  }
+
+  void CheckSealed() {
+#ifndef NDEBUG
+    if (!impl_->sealed_) return;
+    ALWAYS_ASSERT(impl_->Checksum() == impl_->checksum_, logicErr,
+                  "VecDH written through a pointer taken before it was "
+                  "copied.");
+    if (impl_.use_count() == 1) impl_->sealed_ = false;
+#endif
+  }
 };
 
 template <typename T>
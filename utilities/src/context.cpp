@@ -0,0 +1,294 @@
+// Copyright 2022 Emmett Lalish
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "context.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#if MANIFOLD_PAR == 'O'
+#include <omp.h>
+#elif MANIFOLD_PAR == 'T'
+#include <tbb/task_arena.h>
+#include <tbb/task_scheduler_observer.h>
+#endif
+
+namespace {
+using namespace manifold;
+
+constexpr char kOtherSite[] = "other";
+
+thread_local ExecutionContext* current = nullptr;
+
+class Scope {
+ public:
+  Scope(ExecutionContext* context) : previous_(current) { current = context; }
+  ~Scope() { current = previous_; }
+
+ private:
+  ExecutionContext* const previous_;
+};
+
+void RaiseTo(std::atomic<size_t>& peak, size_t value) {
+  size_t old = peak;
+  while (value > old && !peak.compare_exchange_weak(old, value)) {
+  }
+}
+
+#if MANIFOLD_PAR == 'T'
+// The contexts replaced by Enter() on this thread, innermost last.
+thread_local std::vector<ExecutionContext*> replaced;
+
+/**
+ * Makes the context current on a thread that runs work of an Execute() it did
+ * not call, until the matching Leave(), which restores the one it replaced.
+ * Pairs nest, e.g. for a worker joining an Execute() from inside another.
+ */
+void Enter(ExecutionContext* context) {
+  replaced.push_back(current);
+  current = context;
+}
+
+void Leave() {
+  if (replaced.empty()) return;
+  current = replaced.back();
+  replaced.pop_back();
+}
+
+/**
+ * Makes the context current on the worker threads while they run tasks of
+ * this arena, so that their allocations and settings follow it too.
+ */
+class ArenaObserver : public tbb::task_scheduler_observer {
+ public:
+  ArenaObserver(tbb::task_arena& arena, ExecutionContext* context)
+      : tbb::task_scheduler_observer(arena), context_(context) {
+    observe(true);
+  }
+  ~ArenaObserver() { observe(false); }
+
+  void on_scheduler_entry(bool isWorker) override {
+    if (isWorker) Enter(context_);
+  }
+  void on_scheduler_exit(bool isWorker) override {
+    if (isWorker) Leave();
+  }
+
+ private:
+  ExecutionContext* const context_;
+};
+#elif MANIFOLD_PAR == 'O'
+// The context of the Execute() that owns the OpenMP thread pool, if any.
+std::atomic<ExecutionContext*> tenant(nullptr);
+
+/**
+ * OpenMP has no hook for the start of a parallel region, and its pool threads
+ * may serve a different team in each region, so they cannot be told which
+ * Execute() they work for. Instead only one thread may run Execute() at a
+ * time: the tenant, whose context every thread in a parallel region sees. The
+ * tenant and the threads working for it may nest Execute() inside it.
+ */
+class Tenancy {
+ public:
+  Tenancy(ExecutionContext* context) : owner_(!omp_in_parallel()) {
+    if (!owner_) return;
+    if (current == nullptr) {
+      ExecutionContext* expected = nullptr;
+      const bool vacant = tenant.compare_exchange_strong(expected, context);
+      ALWAYS_ASSERT(
+          vacant, userErr,
+          "With OpenMP, only one thread may run Execute() at a time.");
+    } else {
+      previous_ = tenant.exchange(context);
+    }
+  }
+  ~Tenancy() {
+    if (owner_) tenant = previous_;
+  }
+
+ private:
+  ExecutionContext* previous_ = nullptr;
+  const bool owner_;
+};
+#endif
+}  // namespace
+
+namespace manifold {
+
+/**
+ * The context used outside of ExecutionContext::Execute().
+ */
+ExecutionContext& DefaultContext() {
+  static ExecutionContext context;
+  return context;
+}
+
+/**
+ * The context of the innermost Execute() running on this thread, otherwise
+ * DefaultContext(). With OpenMP, threads in a parallel region see the context
+ * of the Execute() that owns the pool.
+ */
+ExecutionContext& CurrentContext() {
+  if (current != nullptr) return *current;
+#if MANIFOLD_PAR == 'O'
+  if (omp_in_parallel()) {
+    ExecutionContext* context = tenant.load();
+    if (context != nullptr) return *context;
+  }
+#endif
+  return DefaultContext();
+}
+
+/**
+ * The fraction of the known steps that are done, from 0 to 1.
+ */
+float Progress::Fraction() const {
+  if (finished_) return 1.0f;
+  const int total = total_;
+  if (total == 0) return 0.0f;
+  return std::min(1.0f, static_cast<float>(done_) / total);
+}
+
+/**
+ * The counters of the named phase, shared by all the name pointers of the same
+ * name, as a phase name may be a literal in several translation units.
+ */
+MemoryUsage::Counters& MemoryUsage::Find(const char* site) {
+  if (site == nullptr) site = kOtherSite;
+  const size_t hash = reinterpret_cast<uintptr_t>(site);
+  for (int i = 0; i < kNumSlots; ++i) {
+    const Slot& slot = slots_[(hash + i) % kNumSlots];
+    const char* key = slot.site.load(std::memory_order_acquire);
+    if (key == nullptr) break;
+    if (key == site) return *slot.counters.load(std::memory_order_relaxed);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::unique_ptr<Counters>& counters = sites_[site];
+  if (!counters) counters.reset(new Counters());
+  for (int i = 0; i < kNumSlots; ++i) {
+    Slot& slot = slots_[(hash + i) % kNumSlots];
+    const char* key = slot.site.load(std::memory_order_relaxed);
+    if (key == site) break;
+    if (key == nullptr) {
+      slot.counters.store(counters.get(), std::memory_order_relaxed);
+      slot.site.store(site, std::memory_order_release);
+      break;
+    }
+  }
+  return *counters;
+}
+
+/**
+ * Charges an allocation to the given phase, or throws memoryErr without
+ * charging it if it would exceed the budget.
+ */
+void MemoryUsage::Allocate(size_t bytes, const char* site) {
+  const size_t current = current_.fetch_add(bytes) + bytes;
+  const size_t budget = budget_;
+  if (budget > 0 && current > budget) {
+    current_ -= bytes;
+    throw memoryErr("Allocating " + std::to_string(bytes) +
+                    " bytes would exceed the memory budget of " +
+                    std::to_string(budget) + " bytes.");
+  }
+  RaiseTo(peak_, current);
+  Counters& counters = Find(site);
+  counters.total += bytes;
+  RaiseTo(counters.peak, counters.current.fetch_add(bytes) + bytes);
+}
+
+void MemoryUsage::Deallocate(size_t bytes, const char* site) {
+  current_ -= bytes;
+  Find(site).current -= bytes;
+}
+
+/**
+ * Starts measuring the peaks from the current usage, e.g. before each request.
+ */
+void MemoryUsage::ResetPeak() {
+  peak_ = current_.load();
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& site : sites_) site.second->peak = site.second->current.load();
+}
+
+/**
+ * The usage of each phase that has allocated, named as in the trace (see
+ * StartTrace()). Allocations outside of any phase are under "other".
+ */
+std::map<std::string, MemoryUsage::Site> MemoryUsage::BySite() const {
+  std::map<std::string, Site> bySite;
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& site : sites_) {
+    Site& usage = bySite[site.first];
+    usage.current = site.second->current;
+    usage.peak = site.second->peak;
+    usage.total = site.second->total;
+  }
+  return bySite;
+}
+
+/**
+ * Marks the end of the given number of steps of a long operation for the
+ * Progress of the current context, if any, and throws canceledErr if it has
+ * been canceled. Pass zero steps to only check for cancellation.
+ */
+void Checkpoint(int steps) {
+  Progress* progress = CurrentContext().progress.get();
+  if (progress == nullptr) return;
+  progress->FinishSteps(steps);
+  if (progress->IsCanceled()) throw canceledErr("Evaluation was canceled.");
+}
+
+/**
+ * Runs the task with this context. The task works on a copy, so settings
+ * changed inside it, e.g. by Manifold::SetCircularSegments(), are dropped when
+ * it returns. With TBB the task runs in its own arena limited to maxThreads;
+ * with OpenMP the thread count of its parallel regions is limited instead.
+ * Either way the worker threads see this context while they work on the task,
+ * and Execute() may be nested. OpenMP's thread pool is shared by the whole
+ * process, so with it only one thread may run Execute() at a time, and others
+ * throw userErr.
+ *
+ * @param task Creates, evaluates and queries Manifolds. Since evaluation is
+ * lazy, the results should be queried inside it to be computed here.
+ */
+void ExecutionContext::Execute(const std::function<void()>& task) const {
+  ExecutionContext context = *this;
+#if MANIFOLD_PAR == 'O'
+  Tenancy tenancy(&context);
+#endif
+  Scope scope(&context);
+#if MANIFOLD_PAR == 'T'
+  tbb::task_arena arena(maxThreads > 0 ? maxThreads
+                                       : tbb::task_arena::automatic);
+  arena.initialize();
+  ArenaObserver observer(arena, &context);
+  arena.execute(task);
+#elif MANIFOLD_PAR == 'O'
+  const int numThreads = omp_get_max_threads();
+  if (maxThreads > 0) omp_set_num_threads(maxThreads);
+  try {
+    task();
+  } catch (...) {
+    omp_set_num_threads(numThreads);
+    throw;
+  }
+  omp_set_num_threads(numThreads);
+#else
+  task();
+#endif
+}
+}  // namespace manifold
@@ -0,0 +1,182 @@
+// Copyright 2022 Emmett Lalish
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <thrust/for_each.h>
+#include <thrust/reduce.h>
+#include <thrust/scan.h>
+#include <thrust/sort.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <thread>
+
+#include "context.h"
+#include "par.h"
+
+namespace {
+using namespace manifold;
+
+#if MANIFOLD_PAR == 'O'
+constexpr char kBackend[] = "OMP";
+#elif MANIFOLD_PAR == 'T'
+constexpr char kBackend[] = "TBB";
+#else
+constexpr char kBackend[] = "CPP";
+#endif
+
+constexpr int kMinSize = 1 << 8;
+constexpr int kRepeats = 3;
+
+struct Hash {
+  __host__ __device__ void operator()(uint32_t& x) {
+    x ^= x >> 16;
+    x *= 0x45d9f3b;
+    x ^= x >> 16;
+  }
+};
+
+/**
+ * Identifies the machine and backend a cache file was calibrated for.
+ */
+std::string Machine() {
+  return std::string("manifold policy v1 ") + kBackend + " " +
+         std::to_string(std::thread::hardware_concurrency());
+}
+
+/**
+ * The fastest of a few runs of one kind of primitive over the input, in
+ * seconds. The buffers are plain std::vectors, since the VecDH allocator
+ * depends on the ExecutionContext that is being set up.
+ */
+template <typename Policy>
+double Measure(const Policy& policy, OpKind kind,
+               const std::vector<uint32_t>& input) {
+  std::vector<uint32_t> data(input.size());
+  double best = std::numeric_limits<double>::infinity();
+  volatile uint32_t sink = 0;
+  for (int i = 0; i < kRepeats; ++i) {
+    std::copy(input.begin(), input.end(), data.begin());
+    const auto start = std::chrono::high_resolution_clock::now();
+    switch (kind) {
+      case OpKind::ForEach:
+        thrust::for_each(policy, data.begin(), data.end(), Hash());
+        break;
+      case OpKind::Sort:
+        thrust::sort(policy, data.begin(), data.end());
+        break;
+      case OpKind::Scan:
+        thrust::inclusive_scan(policy, data.begin(), data.end(), data.begin());
+        break;
+      case OpKind::Reduce:
+        sink = sink + thrust::reduce(policy, data.begin(), data.end());
+        break;
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+    best = std::min(best, std::chrono::duration<double>(end - start).count());
+  }
+  return best;
+}
+
+/**
+ * Doubles the size until the parallel backend beats sequential execution
+ * twice in a row and returns the last size at which it did not.
+ */
+int Crossover(OpKind kind, const std::vector<uint32_t>& random) {
+  const int maxSize = random.size();
+  int wins = 0;
+  for (int size = kMinSize; size <= maxSize; size *= 2) {
+    const std::vector<uint32_t> input(random.begin(), random.begin() + size);
+    const double seq = Measure(thrust::cpp::par, kind, input);
+    const double par = Measure(thrust::MANIFOLD_PAR_NS::par, kind, input);
+    if (par < seq) {
+      if (++wins == 2) return size / 4;
+    } else {
+      wins = 0;
+    }
+  }
+  return maxSize;
+}
+}  // namespace
+
+namespace manifold {
+
+/**
+ * Measures where each kind of primitive starts to run faster on the parallel
+ * backend than sequentially on this machine, which differs widely between a
+ * laptop and a many-core server. This takes up to a second or so; the GPU
+ * threshold is not measured. Without a parallel backend the defaults are
+ * returned.
+ *
+ * @param maxSize The largest workload measured, which is also the largest
+ * threshold returned.
+ */
+PolicyThresholds CalibratePolicy(int maxSize) {
+  PolicyThresholds thresholds;
+  if (std::string(kBackend) == "CPP") return thresholds;
+  std::vector<uint32_t> random(std::max(maxSize, kMinSize));
+  uint32_t x = 1;
+  for (uint32_t& r : random) {
+    Hash()(x += 0x9e3779b9);
+    r = x;
+  }
+  for (int kind = 0; kind < kNumOpKind; ++kind) {
+    thresholds.seq[kind] = Crossover(static_cast<OpKind>(kind), random);
+  }
+  return thresholds;
+}
+
+/**
+ * Reads the thresholds from the cache file if it was written for this machine
+ * and backend, otherwise calibrates them and writes the file.
+ *
+ * @param cacheFile The path of the cache file.
+ * @param maxSize Passed to CalibratePolicy().
+ */
+PolicyThresholds LoadPolicy(const std::string& cacheFile, int maxSize) {
+  const std::string machine = Machine();
+  PolicyThresholds thresholds;
+  std::ifstream in(cacheFile);
+  std::string header;
+  if (std::getline(in, header) && header == machine) {
+    bool valid = true;
+    for (int& seq : thresholds.seq) valid = valid && (in >> seq);
+    valid = valid && (in >> thresholds.par);
+    if (valid) return thresholds;
+  }
+  in.close();
+
+  thresholds = CalibratePolicy(maxSize);
+  std::ofstream out(cacheFile);
+  out << machine << std::endl;
+  for (int seq : thresholds.seq) out << seq << " ";
+  out << thresholds.par << std::endl;
+  return thresholds;
+}
+
+/**
+ * The thresholds every ExecutionContext starts with. These are the built-in
+ * values, unless the environment variable MANIFOLD_POLICY_CACHE names a cache
+ * file, in which case they are calibrated once per machine by LoadPolicy().
+ */
+PolicyThresholds DefaultPolicy() {
+  static const PolicyThresholds thresholds = []() {
+    const char* cacheFile = std::getenv("MANIFOLD_POLICY_CACHE");
+    return cacheFile == nullptr ? PolicyThresholds() : LoadPolicy(cacheFile);
+  }();
+  return thresholds;
+}
+}  // namespace manifold
@@ -0,0 +1,160 @@
+// Copyright 2022 Emmett Lalish
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "trace.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "structs.h"
+
+namespace {
+using namespace manifold;
+
+struct Event {
+  const char* name;
+  TraceClock::time_point start, end;
+};
+
+/**
+ * The events of one thread. Only its own thread appends to it, so its lock is
+ * uncontended except while StopTrace() collects the events.
+ */
+struct ThreadBuffer {
+  std::mutex mutex;
+  std::vector<Event> events;
+  int tid;
+};
+
+struct Registry {
+  std::mutex mutex;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  std::ofstream file;
+  TraceClock::time_point epoch;
+};
+
+Registry& GetRegistry() {
+  static Registry registry;
+  return registry;
+}
+
+ThreadBuffer& GetThreadBuffer() {
+  thread_local std::shared_ptr<ThreadBuffer> buffer;
+  if (buffer == nullptr) {
+    buffer = std::make_shared<ThreadBuffer>();
+    Registry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    buffer->tid = registry.buffers.size() + 1;
+    registry.buffers.push_back(buffer);
+  }
+  return *buffer;
+}
+
+double Microseconds(TraceClock::duration duration) {
+  return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+/**
+ * Traces the whole run of any program into the file named by the environment
+ * variable MANIFOLD_TRACE, without changing its code. A trace still running at
+ * exit is written too, whoever started it.
+ */
+struct EnvironmentTrace {
+  EnvironmentTrace() {
+    // Construct the registry first so that it is destroyed after this.
+    GetRegistry();
+    const char* filename = std::getenv("MANIFOLD_TRACE");
+    if (filename != nullptr) StartTrace(filename);
+  }
+  ~EnvironmentTrace() {
+    if (TraceEnabled()) StopTrace();
+  }
+} environmentTrace;
+}  // namespace
+
+namespace manifold {
+
+std::atomic<bool> traceEnabled{false};
+
+/**
+ * Appends an event to the buffer of the calling thread. Use TraceScope rather
+ * than calling this directly.
+ */
+void RecordTrace(const char* name, TraceClock::time_point start,
+                 TraceClock::time_point end) {
+  ThreadBuffer& buffer = GetThreadBuffer();
+  std::lock_guard<std::mutex> lock(buffer.mutex);
+  buffer.events.push_back({name, start, end});
+}
+
+/**
+ * Starts recording the phases of the library's operations on every thread, to
+ * be written by StopTrace() in the Chrome trace format, which can be opened in
+ * chrome://tracing or https://ui.perfetto.dev. Setting the environment
+ * variable MANIFOLD_TRACE to a filename traces the whole program instead.
+ *
+ * @param filename The JSON file to write. A trace already in progress is
+ * written to its own file first.
+ */
+void StartTrace(const std::string& filename) {
+  if (TraceEnabled()) StopTrace();
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.file.open(filename);
+  ALWAYS_ASSERT(registry.file.is_open(), userErr,
+                "Cannot open trace file " + filename);
+  for (auto& buffer : registry.buffers) {
+    std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+    buffer->events.clear();
+  }
+  registry.epoch = TraceClock::now();
+  traceEnabled = true;
+}
+
+/**
+ * Stops recording and writes the events recorded since StartTrace().
+ */
+void StopTrace() {
+  traceEnabled = false;
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  if (!registry.file.is_open()) return;
+  std::ofstream& file = registry.file;
+  file << std::fixed << std::setprecision(3);
+  file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  for (auto& buffer : registry.buffers) {
+    std::vector<Event> events;
+    {
+      std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+      events.swap(buffer->events);
+    }
+    for (const Event& event : events) {
+      if (event.start < registry.epoch) continue;
+      file << (first ? "\n" : ",\n") << "{\"name\":\"" << event.name
+           << "\",\"cat\":\"manifold\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+           << buffer->tid
+           << ",\"ts\":" << Microseconds(event.start - registry.epoch)
+           << ",\"dur\":" << Microseconds(event.end - event.start) << "}";
+      first = false;
+    }
+  }
+  file << "\n]}" << std::endl;
+  file.close();
+}
+}  // namespace manifold